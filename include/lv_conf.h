@@ -1307,7 +1307,7 @@
 #endif
 
 /** Interface for TFT_eSPI */
-#define LV_USE_TFT_ESPI         1
+#define LV_USE_TFT_ESPI         0	/* src/UI/lvglDisplay.cpp drives TFT_eSPI directly (DMA flush) */
 
 /** Interface for Lovyan_GFX */
 #define LV_USE_LOVYAN_GFX         0
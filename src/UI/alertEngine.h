@@ -0,0 +1,80 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/* Timing and slot bookkeeping of the alert engine (header-only, no LVGL, no heap)
+ * - A pattern is a table of step durations in ms, alternating ON/OFF starting with ON
+ * - Step boundaries are absolute: a late tick catches up instead of stretching the pattern
+ * - alertSystem.cpp owns the slots and paints; everything here works on plain structs
+ */
+
+struct AlertPatternDef {
+	const uint16_t* steps;
+	uint8_t         count;		// even, >= 2
+};
+
+enum class AlertAdvance : uint8_t { Unchanged, Changed, Finished };
+
+struct AlertTiming {
+	const AlertPatternDef* pat;
+	uint32_t startMs;
+	uint32_t stepEndMs;		// tick at which the current step ends
+	uint8_t  step;
+	uint8_t  cyclesLeft;	// 0 = until stopped
+
+	void start(const AlertPatternDef* p, uint8_t cycles, uint32_t now) {
+		pat        = p;
+		cyclesLeft = cycles;
+		step       = 0;
+		startMs    = now;
+		stepEndMs  = now + p->steps[0];
+	}
+
+	// Move past every step boundary at or before 'now'; Finished once the last cycle ends
+	AlertAdvance advance(uint32_t now) {
+		AlertAdvance r = AlertAdvance::Unchanged;
+		while ((int32_t)(now - stepEndMs) >= 0) {
+			if (++step == pat->count) {
+				step = 0;
+				if (cyclesLeft && --cyclesLeft == 0) return AlertAdvance::Finished;
+			}
+			stepEndMs += pat->steps[step];
+			r = AlertAdvance::Changed;
+		}
+		return r;
+	}
+
+	bool on() const { return (step & 1) == 0; }
+};
+
+// Slot for 'obj' among slots[n] (each with .obj, nullptr = free, and .t): its own slot, else
+// the first free one, else the longest-running one, which the caller must release first
+// (*stolen is set)
+template <typename Slot, typename Obj>
+Slot* alertPickSlot(Slot* slots, size_t n, Obj* obj, uint32_t now, bool* stolen) {
+	Slot* freeSlot = nullptr;
+	Slot* oldest = &slots[0];
+	*stolen = false;
+	for (size_t i = 0; i < n; ++i) {
+		Slot& s = slots[i];
+		if (s.obj == obj) return &s;
+		if (!s.obj) { if (!freeSlot) freeSlot = &s; continue; }
+		if (now - s.t.startMs > now - oldest->t.startMs) oldest = &s;
+	}
+	if (freeSlot) return freeSlot;
+	*stolen = true;
+	return oldest;
+}
+
+// ms until the earliest step boundary of the busy slots (at least 1), or -1 if none is busy
+template <typename Slot>
+int32_t alertNextWakeMs(const Slot* slots, size_t n, uint32_t now) {
+	int32_t next = INT32_MAX;
+	for (size_t i = 0; i < n; ++i) {
+		if (!slots[i].obj) continue;
+		const int32_t d = (int32_t)(slots[i].t.stepEndMs - now);
+		if (d < next) next = d;
+	}
+	if (next == INT32_MAX) return -1;
+	return next > 1 ? next : 1;
+}
@@ -1,131 +1,189 @@
 #include "alertSystem.h"
-extern "C" {
-	#include "UI/ui_attention_multi.h"	// standardized colors + double-flash + restore
+#include "alertEngine.h"
+#include "uiFacade.h"
+
+/* ---------- patterns (ms; even steps ON, odd steps OFF) ---------- */
+static const uint16_t DOUBLE_STEPS[]    = { 120, 120, 120, 640 };
+static const uint16_t BLINK_2HZ_STEPS[] = { 250, 250 };
+
+static const AlertPatternDef patterns[(uint8_t)AlertPattern::Count] = {
+	{ DOUBLE_STEPS,    4 },	// AlertPattern::Double
+	{ BLINK_2HZ_STEPS, 2 },	// AlertPattern::Blink2Hz
+};
+
+/* ---------- class targets + palette (dark, high-contrast) ---------- */
+struct ClassTarget {
+	lv_obj_t** panel;		// preferred label
+	lv_obj_t** value;		// fallback
+	uint32_t   bg;
+};
+
+static const ClassTarget classTargets[4] = {
+	{ &uic_apiPanelLabel,     &uic_apiPercentageValueLabel,     0xC62828 },	// Api: red
+	{ &uic_secondsPanelLabel, &uic_secondsPercentageValueLabel, 0x1565C0 },	// Seconds: blue
+	{ &uic_rashiPanelLabel,   &uic_rashiPercentageValueLabel,   0x2E7D32 },	// Rashi: green
+	{ &uic_mangalaPanelLabel, &uic_mangalaPercentageValueLabel, 0xEF6C00 },	// Mangala: orange
+};
+
+static lv_obj_t* classObj(NutClass cls) {
+	const uint8_t i = (uint8_t)cls;
+	if (i >= 4) return nullptr;
+	return *classTargets[i].panel ? *classTargets[i].panel : *classTargets[i].value;
 }
 
-// One uiac context + one auto-stop timer per category
-static uiac_ctx_t  ctxApi, ctxSeconds, ctxRashi, ctxMangala;
-static lv_timer_t* stopApi     = nullptr;
-static lv_timer_t* stopSeconds = nullptr;
-static lv_timer_t* stopRashi   = nullptr;
-static lv_timer_t* stopMangala = nullptr;
+/* ---------- slots ---------- */
+struct AlertSlot {
+	lv_obj_t*   obj;			// nullptr = free
+	AlertTiming t;				// on lv_tick
+	lv_color_t  baseBg, baseText, hiBg, hiText;
+	lv_opa_t    baseBgOpa;
+};
 
-static inline void cancelStop(lv_timer_t** p) {
-	if (p && *p) { lv_timer_del(*p); *p = nullptr; }
+static AlertSlot   slots[ALERT_SLOTS];
+static lv_timer_t* engineTimer = nullptr;
+
+// Objects that already carry our LV_EVENT_DELETE hook (registered once per object)
+static lv_obj_t*   hooked[ALERT_SLOTS];
+
+static std::atomic<uint32_t> statPosted{0};
+static std::atomic<uint32_t> statDropped{0};
+static uint32_t statStolen = 0;
+
+static void paint(const AlertSlot& s, bool on) {
+	lv_obj_set_style_bg_color  (s.obj, on ? s.hiBg : s.baseBg,          LV_PART_MAIN);
+	lv_obj_set_style_bg_opa    (s.obj, on ? LV_OPA_COVER : s.baseBgOpa, LV_PART_MAIN);
+	lv_obj_set_style_text_color(s.obj, on ? s.hiText : s.baseText,      LV_PART_MAIN);
+}
+
+static void release(AlertSlot& s, bool restore) {
+	if (restore && s.obj) paint(s, false);
+	s.obj = nullptr;
+}
+
+// Sleep the shared timer until the earliest step boundary, or pause it
+static void reschedule(uint32_t now) {
+	const int32_t next = alertNextWakeMs(slots, ALERT_SLOTS, now);
+	if (next < 0) { lv_timer_pause(engineTimer); return; }
+	lv_timer_set_period(engineTimer, (uint32_t)next);
+	lv_timer_reset(engineTimer);
+	lv_timer_resume(engineTimer);
+}
+
+// Advance every slot whose step has ended (see AlertTiming::advance)
+static void engineTick(lv_timer_t*) {
+	const uint32_t now = lv_tick_get();
+	for (AlertSlot& s : slots) {
+		if (!s.obj) continue;
+		switch (s.t.advance(now)) {
+			case AlertAdvance::Finished: release(s, true); break;
+			case AlertAdvance::Changed:  paint(s, s.t.on()); break;
+			default: break;
+		}
+	}
+	reschedule(now);
 }
 
-// IMPORTANT: clear the correct global stop* after the timer runs
-static void clearStopByCtx(uiac_ctx_t* ctx) {
-	if      (ctx == &ctxApi)     stopApi     = nullptr;
-	else if (ctx == &ctxSeconds) stopSeconds = nullptr;
-	else if (ctx == &ctxRashi)   stopRashi   = nullptr;
-	else if (ctx == &ctxMangala) stopMangala = nullptr;
+static void onObjDeleted(lv_event_t* e) {
+	lv_obj_t* dead = (lv_obj_t*)lv_event_get_target(e);
+	for (AlertSlot& s : slots)
+		if (s.obj == dead) release(s, false);
+	for (lv_obj_t*& h : hooked)
+		if (h == dead) h = nullptr;
 }
 
-static void stopCb(lv_timer_t* t) {
-	auto* ctx = (uiac_ctx_t*) lv_timer_get_user_data(t);
-	if (ctx) {
-		uiac_stop(ctx);			// helper restores base bg/opa/text
-		clearStopByCtx(ctx);	// avoid dangling pointer on next flash
+// One delete hook per object for its lifetime (the only allocation, on first use)
+static void hookDelete(lv_obj_t* obj) {
+	lv_obj_t** freeHook = nullptr;
+	for (lv_obj_t*& h : hooked) {
+		if (h == obj) return;
+		if (!h && !freeHook) freeHook = &h;
 	}
-	lv_timer_del(t);
+	if (!freeHook) return;	// more distinct objects than slots: go unhooked (not expected)
+	*freeHook = obj;
+	lv_obj_add_event_cb(obj, onObjDeleted, LV_EVENT_DELETE, nullptr);
 }
 
+static AlertSlot* slotFor(lv_obj_t* obj) {
+	bool stolen;
+	AlertSlot* s = alertPickSlot(slots, ALERT_SLOTS, obj, lv_tick_get(), &stolen);
+	if (stolen) {
+		statStolen++;
+		release(*s, true);
+	}
+	return s;
+}
+
+/* ---------- public API ---------- */
 void alertInit() {
-	uiac_init(&ctxApi);
-	uiac_init(&ctxSeconds);
-	uiac_init(&ctxRashi);
-	uiac_init(&ctxMangala);
+	if (!engineTimer) {
+		engineTimer = lv_timer_create(engineTick, 1000, nullptr);
+		lv_timer_pause(engineTimer);
+	}
+	// Pre-create the local style props on the class targets (set them to their current
+	// values) and hook their deletion, so flashing them later never allocates
+	for (uint8_t i = 0; i < 4; ++i) {
+		lv_obj_t* obj = classObj((NutClass)i);
+		if (!obj) continue;
+		lv_obj_set_style_bg_color  (obj, lv_obj_get_style_bg_color(obj, LV_PART_MAIN),   LV_PART_MAIN);
+		lv_obj_set_style_bg_opa    (obj, lv_obj_get_style_bg_opa(obj, LV_PART_MAIN),     LV_PART_MAIN);
+		lv_obj_set_style_text_color(obj, lv_obj_get_style_text_color(obj, LV_PART_MAIN), LV_PART_MAIN);
+		hookDelete(obj);
+	}
 }
 
-// Pick the actual label to flash (fall back for Api/Rashi) + return address of the right stop pointer
-static bool mapTarget(
-	NutClass c,
-	uiac_ctx_t** outCtx,
-	lv_obj_t** outObj,
-	uiac_cat_t* outCat,
-	lv_timer_t*** outStopPtr   // <-- pointer-to-pointer to the correct global stopX
-) {
-	switch (c) {
-		case NutClass::Api:
-			*outCtx    = &ctxApi;
-			*outObj    = uic_apiPanelLabel ? uic_apiPanelLabel : uic_apiPercentageValueLabel;
-			*outCat    = UIAC_CAT_API;
-			*outStopPtr = &stopApi;
-			return *outObj != nullptr;
-
-		case NutClass::Seconds:
-			*outCtx    = &ctxSeconds;
-			*outObj    = uic_secondsPanelLabel ? uic_secondsPanelLabel : uic_secondsPercentageValueLabel;
-			*outCat    = UIAC_CAT_SECONDS;
-			*outStopPtr = &stopSeconds;
-			return *outObj != nullptr;
-
-		case NutClass::Rashi:
-			*outCtx    = &ctxRashi;
-			*outObj    = uic_rashiPanelLabel ? uic_rashiPanelLabel : uic_rashiPercentageValueLabel;
-			*outCat    = UIAC_CAT_RASHI;
-			*outStopPtr = &stopRashi;
-			return *outObj != nullptr;
-
-		case NutClass::Mangala:
-			*outCtx    = &ctxMangala;
-			*outObj    = uic_mangalaPanelLabel ? uic_mangalaPanelLabel : uic_mangalaPercentageValueLabel;
-			*outCat    = UIAC_CAT_MANGALA;
-			*outStopPtr = &stopMangala;
-			return *outObj != nullptr;
-
-		default:
-			return false;
+bool alertStart(lv_obj_t* obj, AlertPattern pat, lv_color_t hiBg, lv_color_t hiText, uint8_t cycles) {
+	if (!obj || (uint8_t)pat >= (uint8_t)AlertPattern::Count) return false;
+	if (!engineTimer) alertInit();
+	hookDelete(obj);
+
+	AlertSlot* s = slotFor(obj);
+	if (s->obj != obj) {	// fresh slot: snapshot what to restore (a restart keeps the original)
+		s->obj       = obj;
+		s->baseBg    = lv_obj_get_style_bg_color(obj, LV_PART_MAIN);
+		s->baseBgOpa = lv_obj_get_style_bg_opa(obj, LV_PART_MAIN);
+		s->baseText  = lv_obj_get_style_text_color(obj, LV_PART_MAIN);
 	}
+	const uint32_t now = lv_tick_get();
+	s->hiBg   = hiBg;
+	s->hiText = hiText;
+	s->t.start(&patterns[(uint8_t)pat], cycles, now);
+	paint(*s, true);		// step 0 is ON: the flash shows on the next frame
+	reschedule(now);
+	return true;
+}
+
+void alertStop(lv_obj_t* obj) {
+	if (!obj) return;
+	for (AlertSlot& s : slots)
+		if (s.obj == obj) release(s, true);
+	if (engineTimer) reschedule(lv_tick_get());
 }
 
 void alertStopAll() {
-	cancelStop(&stopApi);     uiac_stop(&ctxApi);
-	cancelStop(&stopSeconds); uiac_stop(&ctxSeconds);
-	cancelStop(&stopRashi);   uiac_stop(&ctxRashi);
-	cancelStop(&stopMangala); uiac_stop(&ctxMangala);
+	for (AlertSlot& s : slots) release(s, true);
+	if (engineTimer) lv_timer_pause(engineTimer);
 }
 
-// LVGL-thread: start standardized double-flash, auto-stop after one cycle (~1000 ms)
 void alertFlash(NutClass cls) {
-	uiac_ctx_t* ctx = nullptr; lv_obj_t* obj = nullptr; uiac_cat_t cat = UIAC_CAT_API;
-	lv_timer_t** stopPtr = nullptr;
-	if (!mapTarget(cls, &ctx, &obj, &cat, &stopPtr)) {
+	lv_obj_t* obj = classObj(cls);
+	if (!obj) {
 		Serial.printf("[ALERT] skip (no target) for cls=%d\n", (int)cls);
 		return;
 	}
-
-	// Cancel any pending stop for THIS category only, safely
-	cancelStop(stopPtr);
-
-	// Ensure previous run of THIS ctx is fully restored
-	uiac_stop(ctx);
-
-	// Start helper's standardized pattern on label (internally starts its own LVGL timer)
-	uiac_start(ctx, obj, cat);
-
-	// Schedule one-shot stop for THIS category only: 120+120+120+640 = 1000 ms
-	*stopPtr = lv_timer_create(stopCb, 1000, ctx);
-
-	Serial.printf("[ALERT] uiac start cls=%d obj=%p stop=%p\n", (int)cls, (void*)obj, (void*)*stopPtr);
+	alertStart(obj, AlertPattern::Double, lv_color_hex(classTargets[(uint8_t)cls].bg), lv_color_white(), 1);
 }
 
-/* ---------- mailbox: post from web thread, run on LVGL thread ---------- */
-static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-static volatile bool pend = false;
-static volatile NutClass pendCls = NutClass::Unknown;
-
+/* ---------- posting: any task -> uiFacade queue -> LVGL task ---------- */
 void alertPostFlash(NutClass cls) {
-	portENTER_CRITICAL(&mux);
-	pend = true; pendCls = cls;
-	portEXIT_CRITICAL(&mux);
+	if (cls == NutClass::Unknown) return;
+	statPosted.fetch_add(1, std::memory_order_relaxed);
+	if (!uiFacadePostCommand(UiCmdType::Flash, (uint8_t)cls)) statDropped.fetch_add(1, std::memory_order_relaxed);
 }
 
-void alertPoll() {
-	bool doIt = false; NutClass c = NutClass::Unknown;
-	portENTER_CRITICAL(&mux);
-	if (pend) { doIt = true; c = pendCls; pend = false; }
-	portEXIT_CRITICAL(&mux);
-	if (doIt && c != NutClass::Unknown) alertFlash(c);
+AlertStats alertGetStats() {
+	AlertStats st;
+	st.posted  = statPosted.load(std::memory_order_relaxed);
+	st.dropped = statDropped.load(std::memory_order_relaxed);
+	st.stolen  = statStolen;
+	return st;
 }
@@ -8,17 +8,45 @@ extern "C" {
 	#include <lvgl.h>
 }
 
-// Initialize after ui_init()/uiFacadeInit()
+/* Alert animation engine (LVGL task only, except alertPostFlash)
+ *
+ * - A fixed pool of ALERT_SLOTS slots, one per flashing object, all advanced by a single
+ *   lv_timer that sleeps until the earliest step boundary (paused when nothing flashes)
+ * - Patterns are data: step durations in ms, alternating ON/OFF starting with ON
+ * - Starting, restarting or stopping a flash does not allocate: the class targets get
+ *   their local style props and delete hook in alertInit(), other objects on first use
+ */
+
+#ifndef ALERT_SLOTS
+#define ALERT_SLOTS		8
+#endif
+
+enum class AlertPattern : uint8_t {
+	Double,		// 120 on, 120 off, 120 on, 640 off (one cycle = 1 s)
+	Blink2Hz,	// 250 on, 250 off
+	Count
+};
+
+// Initialize after ui_init()/uiFacadeInit(); safe to call again
 void alertInit();
 
-// Start a standardized class flash (double-burst); use alertPostFlash() from web handlers
+// Flash 'obj' with 'pat' for 'cycles' pattern cycles (0 = until stopped). ON paints hiBg
+// (opaque) and hiText; the object's own colors come back when the flash ends. Restarting
+// an object that is already flashing restarts its pattern. Returns false if obj is null.
+bool alertStart(lv_obj_t* obj, AlertPattern pat, lv_color_t hiBg, lv_color_t hiText, uint8_t cycles = 1);
+void alertStop(lv_obj_t* obj);
+
+// Standardized class flash: one Double cycle on the class's panel label
 void alertFlash(NutClass cls);
 
 // Stop any ongoing flashes and restore original styles
 void alertStopAll();
 
-// Thread-safe posting from non-LVGL contexts (e.g., WebServer handlers)
+// Thread-safe posting from non-LVGL contexts (e.g., HTTP handlers); queued through the
+// uiFacade command queue, so back-to-back flashes are all played
 void alertPostFlash(NutClass cls);
 
-// Call once per loop() on the LVGL thread to apply posted flashes
-void alertPoll();
+// posted/dropped: flashes posted, and refused because the UI queue was full.
+// stolen: starts that found every slot busy and recycled the longest-running one.
+struct AlertStats { uint32_t posted; uint32_t dropped; uint32_t stolen; };
+AlertStats alertGetStats();
@@ -0,0 +1,149 @@
+#include "lvglDisplay.h"
+#include <TFT_eSPI.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include "app/metrics.h"
+#include "acq/adcAcquisition.h"
+
+// TFT_eSPI's bus: VSPI unless its setup selects the HSPI port
+#ifdef USE_HSPI_PORT
+#define LVGL_TFT_SPI_HOST	HSPI
+#else
+#define LVGL_TFT_SPI_HOST	VSPI
+#endif
+static const bool busShared = LVGL_TFT_SPI_HOST == ADS1220_SPI_HOST;
+
+static constexpr bool adcPin(int p) {
+	return p == ADS1220_SCK_PIN || p == ADS1220_MISO_PIN || p == ADS1220_MOSI_PIN
+	    || p == ADS1220_CS_PIN || p == ADS1220_DRDY_PIN;
+}
+#if defined(TFT_SCLK) && defined(TFT_MOSI) && defined(TFT_CS) && defined(TFT_DC)
+static_assert(!adcPin(TFT_SCLK) && !adcPin(TFT_MOSI) && !adcPin(TFT_CS) && !adcPin(TFT_DC),
+              "TFT_eSPI pins overlap the ADS1220's (acq/adcAcquisition.h)");
+#endif
+
+static TFT_eSPI tft;
+static uint32_t bufLines = 0;
+static bool     twoBufs = false;
+static bool     dmaPending = false;	// a strip is queued and the SPI transaction is open
+static uint32_t renderStartUs = 0;
+
+/* ---- flush ---- */
+// Finish the strip in flight and release the bus
+static void flushWait(lv_display_t*) {
+	if (!dmaPending) return;
+	const uint32_t t0 = micros();
+	tft.dmaWait();
+	tft.endWrite();
+	dmaPending = false;
+	metricLvglFlushWaitUs.observe(micros() - t0);
+}
+
+static void flushDma(lv_display_t* d, const lv_area_t* area, uint8_t* px) {
+	const uint32_t w = lv_area_get_width(area);
+	const uint32_t h = lv_area_get_height(area);
+	lv_draw_sw_rgb565_swap(px, w * h);	// panel takes big-endian RGB565
+
+	if (!dmaPending) tft.startWrite();
+	tft.pushImageDMA(area->x1, area->y1, w, h, (uint16_t*)px);	// waits for the previous strip
+	dmaPending = true;
+	metricLvglSpiBytes.inc(w * h * 2);
+
+	// single buffer: LVGL renders into 'px' next, so the strip has to be out first.
+	// Shared bus: the ADC must not wait behind more than this strip.
+	if (!twoBufs || busShared) {
+		flushWait(d);
+		lv_display_flush_ready(d);
+	}
+}
+
+/* ---- frame events ---- */
+// Frame time = render + flush of the dirty areas; idle refresh passes send no RENDER_* events
+static void renderEvent(lv_event_t* e) {
+	lv_display_t* d = (lv_display_t*)lv_event_get_current_target(e);
+	switch (lv_event_get_code(e)) {
+		case LV_EVENT_RENDER_START:
+			renderStartUs = micros();
+			break;
+		case LV_EVENT_RENDER_READY:
+			// LVGL leaves the last strip of a frame in flight; close it here rather than
+			// holding CS and the SPI bus until the next frame
+			flushWait(d);
+			lv_display_flush_ready(d);
+			metricLvglFrameUs.observe(micros() - renderStartUs);
+			break;
+		case LV_EVENT_FLUSH_START:
+			metricLvglPixels.inc(lv_area_get_size((const lv_area_t*)lv_event_get_param(e)));
+			break;
+		default: break;
+	}
+}
+
+// LVGL tick straight from the 64-bit esp_timer clock: no lv_tick_inc() bookkeeping to drift
+static uint32_t tickMs() {
+	return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/* ---- buffers ---- */
+static void* dmaAlloc(size_t bytes) {
+	return heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+}
+
+lv_display_t* lvglDisplayCreate(uint16_t hor, uint16_t ver) {
+	lv_init();	// IMPORTANT
+	lv_tick_set_cb(tickMs);
+
+	tft.begin();
+	tft.setRotation(0);
+	tft.initDMA();
+
+	// two buffers if possible, halving toward the minimum before giving up the second one
+	uint32_t lines = LVGL_DRAW_BUF_LINES;
+	void* buf1 = nullptr;
+	void* buf2 = nullptr;
+	for (;;) {
+		const size_t bytes = hor * lines * sizeof(lv_color16_t);
+		buf1 = dmaAlloc(bytes);
+		buf2 = dmaAlloc(bytes);
+		if (buf1 && buf2) break;
+		if (lines <= LVGL_DRAW_BUF_MIN_LINES) {		// last resort: whatever single buffer we got
+			if (!buf1) { buf1 = buf2; }
+			buf2 = nullptr;
+			break;
+		}
+		heap_caps_free(buf1); heap_caps_free(buf2);
+		lines = lines / 2 > LVGL_DRAW_BUF_MIN_LINES ? lines / 2 : LVGL_DRAW_BUF_MIN_LINES;
+	}
+	bufLines = lines;
+	twoBufs  = buf2 != nullptr;
+	if (!buf1) {
+		Serial.println("[DISP] no DMA-capable RAM for a draw buffer");
+		return nullptr;
+	}
+
+	lv_display_t* d = lv_display_create(hor, ver);
+	lv_display_set_color_format(d, LV_COLOR_FORMAT_RGB565);
+	lv_display_set_buffers(d, buf1, buf2, hor * bufLines * sizeof(lv_color16_t), LV_DISPLAY_RENDER_MODE_PARTIAL);
+	lv_display_set_flush_cb(d, flushDma);
+	if (twoBufs && !busShared) lv_display_set_flush_wait_cb(d, flushWait);
+	lv_display_add_event_cb(d, renderEvent, LV_EVENT_RENDER_START, nullptr);
+	lv_display_add_event_cb(d, renderEvent, LV_EVENT_RENDER_READY, nullptr);
+	lv_display_add_event_cb(d, renderEvent, LV_EVENT_FLUSH_START, nullptr);
+	lv_display_set_default(d);	// IMPORTANT
+
+	Serial.printf("[DISP] %ux%u, %s buffer of %u lines, DMA flush%s\n",
+		hor, ver, twoBufs ? "double" : "single", (unsigned)bufLines,
+		busShared ? " (SPI bus shared with the ADC: released per strip)" : "");
+	return d;
+}
+
+uint32_t lvglDisplayBufLines()      { return bufLines; }
+bool     lvglDisplayDoubleBuffered() { return twoBufs; }
+
+uint32_t lvglDisplaySpiHz() {
+#ifdef SPI_FREQUENCY
+	return SPI_FREQUENCY;
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include <lvgl.h>
+
+/* LVGL display on TFT_eSPI with double-buffered DMA flushing
+ *
+ * - Two DMA-capable partial buffers of LVGL_DRAW_BUF_LINES lines each: LVGL renders the
+ *   next strip while the previous one is on the SPI bus
+ * - flush_cb byte-swaps the strip and queues it with pushImageDMA. The first strip opens
+ *   the SPI transaction (startWrite) and it stays open while the DMA runs; it is closed
+ *   (dmaWait + endWrite) in flush_wait_cb, when LVGL needs that buffer back, or on
+ *   RENDER_READY for the last strip of a frame
+ * - The ADS1220 is on its own SPI host (ADS1220_SPI_HOST, acq/adcAcquisition.h) so it never
+ *   waits for a strip. If a build puts both on one host, each strip is waited for and the
+ *   bus released inside flush_cb instead (no render/transfer overlap)
+ */
+
+#ifndef LVGL_DRAW_BUF_LINES
+#define LVGL_DRAW_BUF_LINES		20		// per buffer; 240 x 20 x 2 B = 9.6 KB, two of them
+#endif
+#ifndef LVGL_DRAW_BUF_MIN_LINES
+#define LVGL_DRAW_BUF_MIN_LINES	8		// fall back down to this if DMA RAM is short
+#endif
+
+// lv_init() + display + buffers; returns the (default) display
+lv_display_t* lvglDisplayCreate(uint16_t hor, uint16_t ver);
+
+uint32_t lvglDisplayBufLines();		// lines per buffer actually allocated
+bool     lvglDisplayDoubleBuffered();
+uint32_t lvglDisplaySpiHz();		// TFT SPI clock (for utilisation = bytes * 8 / hz)
@@ -0,0 +1,35 @@
+#include "lvglTask.h"
+#include <lvgl.h>
+#include "uiFacade.h"
+#include "touchInput.h"
+
+static TaskHandle_t lvglTask = nullptr;
+
+static void lvglTaskFn(void*) {
+	for (;;) {
+		// touch points and posts since the last pass, then due timers (refresh included)
+		touchInputPoll();
+		uiFacadePoll();
+		uint32_t waitMs = lv_timer_handler();
+
+		if (waitMs > LVGL_TASK_MAX_SLEEP_MS) waitMs = LVGL_TASK_MAX_SLEEP_MS;	// incl. LV_NO_TIMER_READY
+		TickType_t ticks = pdMS_TO_TICKS(waitMs);
+		if (ticks == 0) ticks = 1;	// never spin: lets loopTask/idle run on this core
+		ulTaskNotifyTake(pdTRUE, ticks);
+	}
+}
+
+bool lvglTaskBegin() {
+	if (lvglTask) return true;
+	if (xTaskCreatePinnedToCore(lvglTaskFn, "lvgl", LVGL_TASK_STACK, nullptr,
+	                            LVGL_TASK_PRIO, &lvglTask, LVGL_TASK_CORE) != pdPASS) {
+		Serial.println("[LVGL] task create failed");
+		return false;
+	}
+	Serial.printf("[LVGL] task on core %d, prio %d\n", LVGL_TASK_CORE, LVGL_TASK_PRIO);
+	return true;
+}
+
+void lvglTaskWake() {
+	if (lvglTask) xTaskNotifyGive(lvglTask);
+}
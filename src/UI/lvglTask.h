@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+/* LVGL render task
+ *
+ * - Owns LVGL after setup(): every lv_* call happens on this task. Other tasks post
+ *   through uiFacadePost*() / alertPostFlash(), which queue the change and wake it
+ * - Sleeps until the next LVGL timer is due (lv_timer_handler's return value) or a post
+ *   arrives; the tick comes from esp_timer (see lvglDisplay.cpp), not loop() deltas
+ * - Pinned to the app core, above async_tcp, so animation timing does not follow HTTP load
+ */
+
+#ifndef LVGL_TASK_CORE
+#define LVGL_TASK_CORE			1
+#endif
+#ifndef LVGL_TASK_PRIO
+#define LVGL_TASK_PRIO			11		// one above async_tcp (CONFIG_ASYNC_TCP_PRIORITY, 10 by default)
+#endif
+#ifndef LVGL_TASK_STACK
+#define LVGL_TASK_STACK			8192
+#endif
+#ifndef LVGL_TASK_MAX_SLEEP_MS
+#define LVGL_TASK_MAX_SLEEP_MS	500		// cap when no LVGL timer is pending
+#endif
+
+// Start the task; call once, after all LVGL setup in setup() is done
+bool lvglTaskBegin();
+
+// Wake the task to apply posted UI changes (any task, not ISRs)
+void lvglTaskWake();
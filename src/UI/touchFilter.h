@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+
+/* Touch sample conditioning (header-only, no Arduino/LVGL): the pure part of touchInput
+ * - median3() over the three X/Y conversions, mapAxis() from raw to screen pixels
+ * - TouchFilter: press/release debounce plus the IIR on raw X/Y (state reset on every
+ *   new contact), fed one sampling pass at a time
+ */
+
+static inline uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+	if (a > b) { const uint16_t t = a; a = b; b = t; }
+	if (b > c) b = c;
+	return a > b ? a : b;
+}
+
+// Raw reading -> pixel in [0, pixels - 1]; readings outside the calibration clamp to the edge
+static inline int16_t mapAxis(int32_t raw, int32_t rawMin, int32_t rawMax, int32_t pixels, bool invert) {
+	int32_t p = (raw - rawMin) * (pixels - 1) / (rawMax - rawMin);
+	if (p < 0) p = 0;
+	if (p > pixels - 1) p = pixels - 1;
+	return (int16_t)(invert ? pixels - 1 - p : p);
+}
+
+class TouchFilter {
+public:
+	TouchFilter(uint8_t pressSamples, uint8_t releaseSamples, uint8_t iirShift)
+		: _pressN(pressSamples), _releaseN(releaseSamples), _shift(iirShift) {}
+
+	// A pass without contact. True on the debounced release edge.
+	bool untouched() {
+		_pressRun = 0;
+		if (!_down || ++_releaseRun < _releaseN) return false;
+		_down = false;
+		return true;
+	}
+
+	// A pass with contact at raw (rx, ry). True while debounced down (every pass, so held
+	// points repeat), with the filtered raw position in ax/ay; *pressEdge marks the first.
+	bool touched(uint16_t rx, uint16_t ry, int32_t& ax, int32_t& ay, bool* pressEdge = nullptr) {
+		_releaseRun = 0;
+		if (_pressRun == 0 && !_down) { _fx = (int32_t)rx << 4; _fy = (int32_t)ry << 4; }	// new contact
+		_fx += (((int32_t)rx << 4) - _fx) >> _shift;
+		_fy += (((int32_t)ry << 4) - _fy) >> _shift;
+		if (pressEdge) *pressEdge = false;
+		if (!_down && ++_pressRun < _pressN) return false;
+		if (!_down && pressEdge) *pressEdge = true;
+		_down = true;
+		ax = _fx >> 4;
+		ay = _fy >> 4;
+		return true;
+	}
+
+	bool down() const { return _down; }
+
+private:
+	uint8_t _pressN, _releaseN, _shift;
+	int32_t _fx = 0, _fy = 0;		// IIR state, raw << 4
+	uint8_t _pressRun = 0, _releaseRun = 0;
+	bool    _down = false;
+};
@@ -0,0 +1,154 @@
+#include "touchInput.h"
+#include "touchFilter.h"
+#include <Wire.h>
+#include <lvgl.h>
+#include "lvglTask.h"
+#include "acq/sampleRing.h"
+#include "app/metrics.h"
+
+// NS2009 conversion commands (12-bit, result in the top bits of two bytes)
+enum : uint8_t { NS2009_READ_X = 0xC0, NS2009_READ_Y = 0xD0, NS2009_READ_Z1 = 0xE0 };
+
+struct TouchPoint {
+	uint32_t tUs;		// micros() at the I2C read
+	int16_t  x, y;		// screen pixels
+	bool     pressed;
+};
+
+static TaskHandle_t touchTask = nullptr;
+static lv_indev_t*  indev = nullptr;
+static int32_t scrW = 0, scrH = 0;
+
+// Touch task -> LVGL task
+static SampleRing<TouchPoint, TOUCH_RING_LEN> touchRing;
+static TouchPoint lastPoint = {};	// LVGL task: what the indev reports between points
+
+static std::atomic<uint32_t> statSamples{0};
+static std::atomic<uint32_t> statPresses{0};
+static std::atomic<uint32_t> statI2cErrors{0};
+
+/* -------------------- sampling (touch task) -------------------- */
+static bool readChannel(uint8_t cmd, uint16_t& out) {
+	Wire.beginTransmission(TOUCH_I2C_ADDR);
+	Wire.write(cmd);
+	if (Wire.endTransmission() != 0) return false;
+	if (Wire.requestFrom((uint8_t)TOUCH_I2C_ADDR, (uint8_t)2) != 2) return false;
+	const uint8_t hi = Wire.read();
+	const uint8_t lo = Wire.read();
+	out = (uint16_t)hi << 4 | lo >> 4;
+	return true;
+}
+
+static bool readMedian(uint8_t cmd, uint16_t& out) {
+	uint16_t v[3];
+	for (uint8_t i = 0; i < 3; ++i) if (!readChannel(cmd, v[i])) return false;
+	out = median3(v[0], v[1], v[2]);
+	return true;
+}
+
+static bool emit(const TouchPoint& p) {
+	if (!touchRing.push(p)) return false;	// overflow is counted by the ring
+	lvglTaskWake();
+	return true;
+}
+
+static void touchTaskFn(void*) {
+	TouchFilter filter(TOUCH_DEBOUNCE_PRESS, TOUCH_DEBOUNCE_RELEASE, TOUCH_IIR_SHIFT);
+	bool     releasePending = false;
+	TouchPoint cur = {};
+	TickType_t wake = xTaskGetTickCount();
+
+	for (;;) {
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(TOUCH_SAMPLE_MS));
+		statSamples.fetch_add(1, std::memory_order_relaxed);
+		if (releasePending) releasePending = !emit(cur);	// a lost release would leave LVGL pressed
+
+		const uint32_t tUs = micros();
+		uint16_t z1 = 0, rx = 0, ry = 0;
+		if (!readChannel(NS2009_READ_Z1, z1)) { statI2cErrors.fetch_add(1, std::memory_order_relaxed); continue; }
+		const bool touched = z1 > TOUCH_Z_MIN;
+		if (touched && !(readMedian(NS2009_READ_X, rx) && readMedian(NS2009_READ_Y, ry))) {
+			statI2cErrors.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		if (!touched) {
+			if (filter.untouched()) {
+				cur.tUs = tUs;
+				cur.pressed = false;
+				releasePending = !emit(cur);
+			}
+			continue;
+		}
+
+#ifdef TOUCH_LOG_RAW
+		Serial.printf("[TOUCH] raw x=%u y=%u z1=%u\n", rx, ry, z1);
+#endif
+		int32_t ax, ay;
+		bool pressEdge;
+		if (!filter.touched(rx, ry, ax, ay, &pressEdge)) continue;
+		if (pressEdge) statPresses.fetch_add(1, std::memory_order_relaxed);
+		releasePending = false;		// still (or again) pressed: the next point supersedes it
+
+		if (TOUCH_SWAP_XY) { const int32_t t = ax; ax = ay; ay = t; }
+		cur.tUs     = tUs;
+		cur.x       = mapAxis(ax, TOUCH_CAL_X_MIN, TOUCH_CAL_X_MAX, scrW, TOUCH_INVERT_X);
+		cur.y       = mapAxis(ay, TOUCH_CAL_Y_MIN, TOUCH_CAL_Y_MAX, scrH, TOUCH_INVERT_Y);
+		cur.pressed = true;
+		emit(cur);	// held points repeat every sample so LVGL can time long presses
+	}
+}
+
+/* -------------------- LVGL side -------------------- */
+// One queued point per call; continue_reading makes LVGL process the backlog in order
+static void touchRead(lv_indev_t*, lv_indev_data_t* data) {
+	TouchPoint p;
+	if (touchRing.pop(p)) {
+		lastPoint = p;
+		metricTouchLatencyUs.observe(micros() - p.tUs);
+		data->continue_reading = !touchRing.empty();
+	}
+	data->point.x = lastPoint.x;
+	data->point.y = lastPoint.y;
+	data->state   = lastPoint.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+void touchInputPoll() {
+	if (indev && !touchRing.empty()) lv_indev_read(indev);
+}
+
+bool touchInputBegin() {
+	if (touchTask) return true;
+
+	Wire.begin(TOUCH_SDA_PIN, TOUCH_SCL_PIN, TOUCH_I2C_HZ);
+	Wire.beginTransmission(TOUCH_I2C_ADDR);
+	if (Wire.endTransmission() != 0) {
+		Serial.printf("[TOUCH] NS2009 not found at 0x%02X\n", TOUCH_I2C_ADDR);
+		return false;
+	}
+
+	scrW = lv_display_get_horizontal_resolution(nullptr);
+	scrH = lv_display_get_vertical_resolution(nullptr);
+	indev = lv_indev_create();
+	lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+	lv_indev_set_read_cb(indev, touchRead);
+	lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);	// read only when touchInputPoll() has points
+
+	if (xTaskCreatePinnedToCore(touchTaskFn, "touch", TOUCH_TASK_STACK, nullptr,
+	                            TOUCH_TASK_PRIO, &touchTask, TOUCH_TASK_CORE) != pdPASS) {
+		Serial.println("[TOUCH] task create failed");
+		return false;
+	}
+	Serial.printf("[TOUCH] NS2009 @0x%02X, %d ms sampling on core %d\n",
+		TOUCH_I2C_ADDR, TOUCH_SAMPLE_MS, TOUCH_TASK_CORE);
+	return true;
+}
+
+TouchInputStats touchInputGetStats() {
+	TouchInputStats st;
+	st.samples   = statSamples.load(std::memory_order_relaxed);
+	st.presses   = statPresses.load(std::memory_order_relaxed);
+	st.i2cErrors = statI2cErrors.load(std::memory_order_relaxed);
+	st.dropped   = touchRing.overflows();
+	return st;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <Arduino.h>
+
+/* NS2009 resistive touch -> LVGL pointer input
+ *
+ * - A sampling task (TOUCH_SAMPLE_MS) owns the I2C bus: pressure (Z1) decides contact,
+ *   X/Y are read three times each and median-filtered, then smoothed by an IIR
+ *   (reset on every new contact) and mapped to screen pixels with the TOUCH_CAL_* values
+ * - Press needs TOUCH_DEBOUNCE_PRESS touched samples in a row, release
+ *   TOUCH_DEBOUNCE_RELEASE untouched ones
+ * - Points (timestamped at the I2C read) go through a SPSC ring to the LVGL task, which
+ *   is woken per point; the indev runs in event mode and drains the ring in
+ *   touchInputPoll(), so an I2C read never runs on the render task and a quick tap
+ *   between two frames still arrives as press + release
+ */
+
+#ifndef TOUCH_I2C_ADDR
+#define TOUCH_I2C_ADDR			0x48
+#endif
+#ifndef TOUCH_SDA_PIN
+#define TOUCH_SDA_PIN			21
+#endif
+#ifndef TOUCH_SCL_PIN
+#define TOUCH_SCL_PIN			22
+#endif
+#ifndef TOUCH_I2C_HZ
+#define TOUCH_I2C_HZ			400000
+#endif
+#ifndef TOUCH_TASK_CORE
+#define TOUCH_TASK_CORE			1
+#endif
+#ifndef TOUCH_TASK_PRIO
+#define TOUCH_TASK_PRIO			12		// above the LVGL task: a sample is a few hundred µs of I2C
+#endif
+#ifndef TOUCH_TASK_STACK
+#define TOUCH_TASK_STACK		3072
+#endif
+#ifndef TOUCH_SAMPLE_MS
+#define TOUCH_SAMPLE_MS			10
+#endif
+#ifndef TOUCH_Z_MIN
+#define TOUCH_Z_MIN				60		// Z1 above this counts as contact
+#endif
+#ifndef TOUCH_IIR_SHIFT
+#define TOUCH_IIR_SHIFT			1		// y += (x - y) >> shift
+#endif
+#ifndef TOUCH_DEBOUNCE_PRESS
+#define TOUCH_DEBOUNCE_PRESS	2
+#endif
+#ifndef TOUCH_DEBOUNCE_RELEASE
+#define TOUCH_DEBOUNCE_RELEASE	3
+#endif
+#ifndef TOUCH_RING_LEN
+#define TOUCH_RING_LEN			32		// power of two
+#endif
+
+// Raw 12-bit readings at the screen edges (build with -D TOUCH_LOG_RAW to measure).
+// Swap/invert happen before the mapping.
+#ifndef TOUCH_CAL_X_MIN
+#define TOUCH_CAL_X_MIN			200
+#endif
+#ifndef TOUCH_CAL_X_MAX
+#define TOUCH_CAL_X_MAX			3900
+#endif
+#ifndef TOUCH_CAL_Y_MIN
+#define TOUCH_CAL_Y_MIN			250
+#endif
+#ifndef TOUCH_CAL_Y_MAX
+#define TOUCH_CAL_Y_MAX			3850
+#endif
+#ifndef TOUCH_SWAP_XY
+#define TOUCH_SWAP_XY			0
+#endif
+#ifndef TOUCH_INVERT_X
+#define TOUCH_INVERT_X			0
+#endif
+#ifndef TOUCH_INVERT_Y
+#define TOUCH_INVERT_Y			0
+#endif
+
+// Register the LVGL pointer and start the sampling task; call in setup() after
+// lvglDisplayCreate() and before lvglTaskBegin(). Returns false if the NS2009 does not answer.
+bool touchInputBegin();
+
+// LVGL task: feed queued points to the indev
+void touchInputPoll();
+
+struct TouchInputStats {
+	uint32_t samples;		// sampling passes
+	uint32_t presses;		// debounced press edges
+	uint32_t i2cErrors;		// failed transfers (the sample is skipped)
+	uint32_t dropped;		// points refused by a full ring
+};
+TouchInputStats touchInputGetStats();
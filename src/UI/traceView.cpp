@@ -0,0 +1,158 @@
+#include "traceView.h"
+#include "uiFacade.h"
+#include "app/traceTap.h"
+
+#ifndef TRACE_MIN_SPAN
+#define TRACE_MIN_SPAN		2000	// smallest y span in ADC codes, so idle noise is not blown up
+#endif
+
+enum : uint8_t { SER_MAX = 0, SER_MIN = 1, SER_BASE = 2, SER_COUNT = 3 };
+
+struct TraceChart {
+	lv_obj_t* chart = nullptr;
+	lv_obj_t* label = nullptr;
+	lv_chart_series_t* ser[SER_COUNT] = {};
+};
+
+static lv_obj_t*  overlay = nullptr;
+static TraceChart liveChart, nutChart;
+static uint32_t   nutShownSeq = 0;
+static TraceEnvelope scratch;		// LVGL task only
+
+static std::atomic<bool> traceQueued{false};
+
+// nutPipe task: one queued refresh at a time, later notifications fold into it
+static void postTrace() {
+	if (traceQueued.exchange(true)) return;
+	if (!uiFacadePostCommand(UiCmdType::Trace)) traceQueued.store(false);
+}
+
+static const char* className(uint8_t cls) {
+	static const char* names[] = { "Api", "Seconds", "Rashi", "Mangala" };
+	return cls < 4 ? names[cls] : "Unknown";
+}
+
+static void buildChart(TraceChart& tc, lv_obj_t* parent) {
+	tc.label = lv_label_create(parent);
+	lv_obj_set_width(tc.label, LV_PCT(100));
+	lv_obj_set_style_text_color(tc.label, lv_color_hex(0xFFFFFF), 0);
+	lv_label_set_text(tc.label, "");
+
+	tc.chart = lv_chart_create(parent);
+	lv_obj_set_width(tc.chart, LV_PCT(100));
+	lv_obj_set_flex_grow(tc.chart, 1);
+	lv_chart_set_type(tc.chart, LV_CHART_TYPE_LINE);
+	lv_chart_set_point_count(tc.chart, TRACE_POINTS);
+	lv_chart_set_div_line_count(tc.chart, 3, 0);
+	lv_obj_set_style_pad_all(tc.chart, 2, 0);
+	lv_obj_set_style_bg_color(tc.chart, lv_color_hex(0x101418), 0);
+	lv_obj_set_style_border_color(tc.chart, lv_color_hex(0x37474F), 0);
+	lv_obj_set_style_line_color(tc.chart, lv_color_hex(0x263238), LV_PART_MAIN);
+	lv_obj_set_style_size(tc.chart, 0, 0, LV_PART_INDICATOR);	// lines only, no point markers
+	lv_obj_set_style_line_width(tc.chart, 1, LV_PART_ITEMS);
+
+	tc.ser[SER_MAX]  = lv_chart_add_series(tc.chart, lv_color_hex(0x29B6F6), LV_CHART_AXIS_PRIMARY_Y);
+	tc.ser[SER_MIN]  = lv_chart_add_series(tc.chart, lv_color_hex(0x29B6F6), LV_CHART_AXIS_PRIMARY_Y);
+	tc.ser[SER_BASE] = lv_chart_add_series(tc.chart, lv_color_hex(0xFFB300), LV_CHART_AXIS_PRIMARY_Y);
+	lv_chart_set_all_values(tc.chart, tc.ser[SER_MAX],  LV_CHART_POINT_NONE);
+	lv_chart_set_all_values(tc.chart, tc.ser[SER_MIN],  LV_CHART_POINT_NONE);
+	lv_chart_set_all_values(tc.chart, tc.ser[SER_BASE], LV_CHART_POINT_NONE);
+}
+
+// Write the envelope straight into the series arrays; unused points are left blank
+static void fillChart(TraceChart& tc, const TraceEnvelope& e) {
+	int32_t* ys[SER_COUNT];
+	for (uint8_t s = 0; s < SER_COUNT; ++s) ys[s] = lv_chart_get_series_y_array(tc.chart, tc.ser[s]);
+
+	int32_t lo = e.lo, hi = e.hi;
+	for (uint16_t i = 0; i < TRACE_POINTS; ++i) {
+		if (i < e.points) {
+			ys[SER_MAX][i]  = e.mx[i];
+			ys[SER_MIN][i]  = e.mn[i];
+			ys[SER_BASE][i] = e.base[i];
+			if (e.base[i] < lo) lo = e.base[i];
+			if (e.base[i] > hi) hi = e.base[i];
+		} else {
+			ys[SER_MAX][i] = ys[SER_MIN][i] = ys[SER_BASE][i] = LV_CHART_POINT_NONE;
+		}
+	}
+	if (hi - lo < TRACE_MIN_SPAN) {
+		const int32_t mid = lo / 2 + hi / 2;
+		lo = mid - TRACE_MIN_SPAN / 2;
+		hi = mid + TRACE_MIN_SPAN / 2;
+	}
+	const int32_t pad = (hi - lo) / 16;
+	lv_chart_set_axis_range(tc.chart, LV_CHART_AXIS_PRIMARY_Y, lo - pad, hi + pad);
+	lv_chart_refresh(tc.chart);
+
+	lv_obj_set_style_text_color(tc.label, e.saturated ? lv_color_hex(0xFF5252) : lv_color_hex(0xFFFFFF), 0);
+}
+
+static void refreshLive() {
+	if (!traceTapReadLive(scratch)) return;		// torn: the next notification retries
+	fillChart(liveChart, scratch);
+	const int32_t drift = scratch.points ? scratch.base[scratch.points - 1] - scratch.base[0] : 0;
+	lv_label_set_text_fmt(liveChart.label, "%sLIVE  b %ld  d %+ld  pp %ld",
+		scratch.saturated ? "SAT " : "", (long)(scratch.points ? scratch.base[scratch.points - 1] : 0),
+		(long)drift, (long)(scratch.hi - scratch.lo));
+}
+
+static void refreshNut() {
+	if (!traceTapReadNut(scratch) || scratch.seq == nutShownSeq) return;
+	nutShownSeq = scratch.seq;
+	fillChart(nutChart, scratch);
+	lv_label_set_text_fmt(nutChart.label, "%s#%lu %s  b %ld  pp %ld",
+		scratch.saturated ? "SAT " : "", (unsigned long)scratch.seq, className(scratch.cls),
+		(long)scratch.base[0], (long)(scratch.hi - scratch.lo));
+}
+
+static void headerClicked(lv_event_t*) { traceViewShow(!traceViewShown()); }
+
+void traceViewInit() {
+	if (overlay || !uic_Screen1) return;
+
+	const int32_t top = uic_headerPanel ? lv_obj_get_y(uic_headerPanel) + lv_obj_get_height(uic_headerPanel) + 5 : 0;
+	overlay = lv_obj_create(uic_Screen1);
+	lv_obj_remove_style_all(overlay);
+	lv_obj_set_size(overlay, LV_PCT(100), lv_display_get_vertical_resolution(nullptr) - top);
+	lv_obj_align(overlay, LV_ALIGN_TOP_MID, 0, top);
+	lv_obj_set_style_bg_color(overlay, lv_color_hex(0x000000), 0);
+	lv_obj_set_style_bg_opa(overlay, LV_OPA_COVER, 0);
+	lv_obj_set_style_pad_all(overlay, 4, 0);
+	lv_obj_set_style_pad_row(overlay, 2, 0);
+	lv_obj_set_flex_flow(overlay, LV_FLEX_FLOW_COLUMN);
+	lv_obj_remove_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
+	lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+
+	buildChart(liveChart, overlay);
+	buildChart(nutChart, overlay);
+	lv_label_set_text(nutChart.label, "no nut yet");
+
+	if (uic_headerPanel) {
+		lv_obj_add_flag(uic_headerPanel, LV_OBJ_FLAG_CLICKABLE);
+		lv_obj_add_event_cb(uic_headerPanel, headerClicked, LV_EVENT_CLICKED, nullptr);
+	}
+}
+
+void traceViewShow(bool show) {
+	if (!overlay || show == traceViewShown()) return;
+	if (show) {
+		lv_obj_remove_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+		nutShownSeq = 0;
+		traceViewRefresh();
+		traceTapSetNotify(postTrace);
+	} else {
+		traceTapSetNotify(nullptr);
+		lv_obj_add_flag(overlay, LV_OBJ_FLAG_HIDDEN);
+	}
+	Serial.printf("[UI] trace view %s\n", show ? "on" : "off");
+}
+
+bool traceViewShown() { return overlay && !lv_obj_has_flag(overlay, LV_OBJ_FLAG_HIDDEN); }
+
+void traceViewRefresh() {
+	traceQueued.store(false);	// before reading, so a later notification re-queues
+	if (!traceViewShown()) return;
+	refreshLive();
+	refreshNut();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+/* On-screen scope: live ADC envelope + last nut window (LVGL task only, except where noted)
+ *
+ * - Built hidden by traceViewInit() below the header; tapping the header toggles it
+ * - While shown, the nutPipe task's trace notifications post one coalesced
+ *   UiCmdType::Trace command; the LVGL task then copies the seqlocked envelopes
+ *   (app/traceTap) into the charts. Hidden, nothing is posted or drawn.
+ * - Each chart draws min/max lines plus the segmenter baseline at a fixed TRACE_POINTS,
+ *   so the redraw cost does not depend on the ADC data rate
+ * - Labels: b = baseline, d = baseline drift across the live span, pp = peak-to-peak;
+ *   SAT (red) when the envelope reaches TRACE_SAT_CODE
+ */
+
+// Initialize after ui_init()/uiFacadeInit()
+void traceViewInit();
+
+void traceViewShow(bool show);
+bool traceViewShown();
+
+// Re-read the envelopes and redraw the charts (UiCmdType::Trace)
+void traceViewRefresh();
@@ -1,11 +1,19 @@
 #include "uiFacade.h"
+#include "lvglTask.h"
+#include "alertSystem.h"
+#include "traceView.h"
+#include "acq/sampleRing.h"
 
 static inline int clamp0_100(int v) { if (v < 0) return 0; if (v > 100) return 100; return v; }
 
-static void setLabelInt(lv_obj_t* lbl, int v) {
-	if (!lbl) return;
+// lv_label_set_text invalidates just the label's area (old and new extent); skipping an
+// unchanged value keeps a busy session from redrawing labels that look the same
+static bool setLabelInt(lv_obj_t* lbl, int v) {
+	if (!lbl) return false;
 	char buf[8]; snprintf(buf, sizeof(buf), "%d", clamp0_100(v));
+	if (strcmp(lv_label_get_text(lbl), buf) == 0) return false;
 	lv_label_set_text(lbl, buf);
+	return true;
 }
 
 // ---- init ----
@@ -23,87 +31,143 @@ void uiFacadeInit() {
 	);
 }
 
-// ---- immediate setters (LVGL thread) ----
+/* ---- immediate setters (LVGL thread) ----
+ * Setters only mark dirty areas; LVGL's refresh timer renders them on its normal
+ * period (LV_DEF_REFR_PERIOD), so a burst of updates costs one partial frame.
+ * Build with -D UI_LOG_UPDATES to log each change: a Serial line here runs on the
+ * LVGL task and can cost more than the redraw it reports. */
 void uiFacadeSetPercentages(int api, int seconds, int rashi, int mangala) {
-	setLabelInt(uic_apiPercentageValueLabel,     api);
-	setLabelInt(uic_secondsPercentageValueLabel, seconds);
-	setLabelInt(uic_rashiPercentageValueLabel,   rashi);
-	setLabelInt(uic_mangalaPercentageValueLabel, mangala);
+	bool changed = setLabelInt(uic_apiPercentageValueLabel,     api);
+	changed |= setLabelInt(uic_secondsPercentageValueLabel, seconds);
+	changed |= setLabelInt(uic_rashiPercentageValueLabel,   rashi);
+	changed |= setLabelInt(uic_mangalaPercentageValueLabel, mangala);
 
-	if (uic_apiPercentageValueLabel)     lv_obj_invalidate(uic_apiPercentageValueLabel);
-	if (uic_secondsPercentageValueLabel) lv_obj_invalidate(uic_secondsPercentageValueLabel);
-	if (uic_rashiPercentageValueLabel)   lv_obj_invalidate(uic_rashiPercentageValueLabel);
-	if (uic_mangalaPercentageValueLabel) lv_obj_invalidate(uic_mangalaPercentageValueLabel);
-
-	lv_obj_t* root = lv_screen_active();
-	if (root) lv_obj_invalidate(root);
-	lv_refr_now(lv_display_get_default());
-
-	Serial.printf("[UI] set %% -> A:%d S:%d R:%d M:%d\n", api, seconds, rashi, mangala);
+#ifdef UI_LOG_UPDATES
+	if (changed) Serial.printf("[UI] set %% -> A:%d S:%d R:%d M:%d\n", api, seconds, rashi, mangala);
+#else
+	(void)changed;
+#endif
 }
 
+enum : int8_t { BATCH_SHOWN_UNSET = -1, BATCH_SHOWN_CLEAR = 0, BATCH_SHOWN_PASS = 1, BATCH_SHOWN_FAIL = 2, BATCH_SHOWN_LOG_ERROR = 3 };
+static int8_t batchShown = BATCH_SHOWN_UNSET;
+
 void uiFacadeSetBatchResult(bool pass) {
 	if (!uic_batchResult) return;
+	const int8_t want = pass ? BATCH_SHOWN_PASS : BATCH_SHOWN_FAIL;
+	if (batchShown == want) return;
+	batchShown = want;
 	lv_label_set_text(uic_batchResult, pass ? "PASS" : "FAIL");
 	lv_obj_set_style_text_color(
 		uic_batchResult,
 		pass ? lv_color_hex(0x00C853) : lv_color_hex(0xD32F2F),
 		LV_PART_MAIN
 	);
-	lv_obj_invalidate(uic_batchResult);
-	lv_obj_t* root = lv_screen_active();
-	if (root) lv_obj_invalidate(root);
-	lv_refr_now(lv_display_get_default());
 
+#ifdef UI_LOG_UPDATES
 	Serial.printf("[UI] batch result -> %s\n", pass ? "PASS" : "FAIL");
+#endif
+}
+
+// Shares the result label: a batch started while the log is failing has no result worth showing
+void uiFacadeSetLogError() {
+	if (!uic_batchResult || batchShown == BATCH_SHOWN_LOG_ERROR) return;
+	batchShown = BATCH_SHOWN_LOG_ERROR;
+	lv_label_set_text(uic_batchResult, "LOG ERROR");
+	lv_obj_set_style_text_color(uic_batchResult, lv_color_hex(0xFF6D00), LV_PART_MAIN);
 }
 
 void uiFacadeClearBatchResult() {
-	if (!uic_batchResult) return;
+	if (!uic_batchResult || batchShown == BATCH_SHOWN_CLEAR) return;
+	batchShown = BATCH_SHOWN_CLEAR;
 	lv_label_set_text(uic_batchResult, "");
-	lv_obj_invalidate(uic_batchResult);
-	lv_obj_t* root = lv_screen_active();
-	if (root) lv_obj_invalidate(root);
-	lv_refr_now(lv_display_get_default());
 }
 
-/* -------------------- mailbox (cross-task) -------------------- */
-static portMUX_TYPE uiMux = portMUX_INITIALIZER_UNLOCKED;
+/* -------------------- command queue (cross-task) -------------------- */
+#ifndef UI_QUEUE_LEN
+#define UI_QUEUE_LEN	32		// power of two
+#endif
 
-static volatile bool pendPerc = false;
-static volatile int  pendA = 0, pendS = 0, pendR = 0, pendM = 0;
+static MpscQueue<UiCommand, UI_QUEUE_LEN> uiQueue;
 
-static volatile bool pendBatch = false;
-static volatile bool pendBatchPass = false;
+// Percentages coalesce: producers overwrite one packed slot and only the first post since
+// the LVGL task last read it enqueues a command. Discrete commands are queued one by one.
+static CoalescingSlot percSlot;		// api | sec << 8 | rashi << 16 | mangala << 24
 
-static volatile bool pendUnknown = false;
+static std::atomic<uint32_t> statPercPosted{0};
+static std::atomic<uint32_t> statPercCoalesced{0};
+static std::atomic<uint32_t> statDropped{0};
+static std::atomic<uint32_t> statHighWater{0};
+static std::atomic<uint32_t> statPickRefused{0};
 
-void uiFacadePostPercentages(int api, int seconds, int rashi, int mangala) {
-	portENTER_CRITICAL(&uiMux);
-	pendA = api; pendS = seconds; pendR = rashi; pendM = mangala;
-	pendPerc = true;
-	portEXIT_CRITICAL(&uiMux);
+static bool postCommand(const UiCommand& cmd) {
+	if (!uiQueue.push(cmd)) {
+		statDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	const uint32_t fill = uiQueue.size();
+	if (fill > statHighWater.load(std::memory_order_relaxed)) statHighWater.store(fill, std::memory_order_relaxed);
+	lvglTaskWake();
+	return true;
 }
 
-void uiFacadePostBatchResult(bool pass) {
-	portENTER_CRITICAL(&uiMux);
-	pendBatchPass = pass;
-	pendBatch = true;
-	portEXIT_CRITICAL(&uiMux);
+bool uiFacadePostCommand(UiCmdType type, uint8_t arg) { return postCommand(UiCommand{ type, arg, NutRef{} }); }
+
+void uiFacadePostPercentages(int api, int seconds, int rashi, int mangala) {
+	const bool queue = percSlot.post((uint32_t)clamp0_100(api) | (uint32_t)clamp0_100(seconds) << 8
+	                               | (uint32_t)clamp0_100(rashi) << 16 | (uint32_t)clamp0_100(mangala) << 24);
+	statPercPosted.fetch_add(1, std::memory_order_relaxed);
+	if (!queue) {	// a queued update will pick these values up
+		statPercCoalesced.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	if (!uiFacadePostCommand(UiCmdType::Percentages)) percSlot.cancel();	// next post retries
 }
 
-void uiFacadePostShowUnknownPrompt() {
-	portENTER_CRITICAL(&uiMux);
-	pendUnknown = true;
-	portEXIT_CRITICAL(&uiMux);
+UiFacadeStats uiFacadeGetStats() {
+	UiFacadeStats st;
+	st.posted    = statPercPosted.load(std::memory_order_relaxed);
+	st.coalesced = statPercCoalesced.load(std::memory_order_relaxed);
+	st.dropped   = statDropped.load(std::memory_order_relaxed);
+	st.highWater = statHighWater.load(std::memory_order_relaxed);
+	st.pickRefused = statPickRefused.load(std::memory_order_relaxed);
+	return st;
 }
 
+void uiFacadePostBatchResult(bool pass) { uiFacadePostCommand(UiCmdType::BatchResult, pass ? 1 : 0); }
+void uiFacadePostClearBatchResult()     { uiFacadePostCommand(UiCmdType::ClearBatch); }
+void uiFacadePostRedraw()               { uiFacadePostCommand(UiCmdType::Redraw); }
+void uiFacadePostLogError()             { uiFacadePostCommand(UiCmdType::LogError); }
+void uiFacadePostShowUnknownPrompt(const NutRef& nut) { postCommand(UiCommand{ UiCmdType::UnknownPrompt, 0, nut }); }
+
 /* -------------------- Unknown modal -------------------- */
+#ifndef UI_UNKNOWN_QUEUE
+#define UI_UNKNOWN_QUEUE	16		// prompts waiting behind the one on screen; power of two
+#endif
+
+struct UnknownPick {
+	NutRef   nut;
+	NutClass cls;
+};
+
 static lv_obj_t* unknownOverlay = nullptr;
+static lv_obj_t* unknownTitle = nullptr;
+static NutRef    unknownShown = {};		// the nut the prompt on screen is for
+static SampleRing<NutRef, UI_UNKNOWN_QUEUE> unknownWaiting;	// LVGL task only
 static UnknownCommitFn unknownCommit = nullptr;
+static SampleRing<UnknownPick, 4> commitRing;	// LVGL task -> loop()
+
+static void showUnknownNow();
 
 void uiFacadeRegisterUnknownCommit(UnknownCommitFn fn) { unknownCommit = fn; }
 
+void uiFacadePollCommits() {
+	UnknownPick p;
+	while (commitRing.pop(p)) {
+		if (unknownCommit) unknownCommit(p.cls, p.nut);
+	}
+}
+
 static void unknownPick(lv_event_t* e) {
 	if (!unknownOverlay) return;
 	lv_obj_t* btn = (lv_obj_t*) lv_event_get_target(e);
@@ -116,8 +180,29 @@ static void unknownPick(lv_event_t* e) {
 		else if (!strcmp(txt, "Rashi"))   chosen = NutClass::Rashi;
 		else if (!strcmp(txt, "Mangala")) chosen = NutClass::Mangala;
 	}
-	if (unknownCommit && chosen != NutClass::Unknown) unknownCommit(chosen);
-	lv_obj_del(unknownOverlay); unknownOverlay = nullptr;
+	if (chosen == NutClass::Unknown) return;
+	if (!commitRing.push(UnknownPick{ unknownShown, chosen })) {
+		// loop() is behind: keep this prompt up so the pick is not lost, and ask again
+		statPickRefused.fetch_add(1, std::memory_order_relaxed);
+		if (unknownTitle) lv_label_set_text(unknownTitle, "Busy saving - tap again");
+		return;
+	}
+	lv_obj_del(unknownOverlay); unknownOverlay = nullptr; unknownTitle = nullptr;
+	if (unknownWaiting.pop(unknownShown)) showUnknownNow();
+}
+
+static void setUnknownTitle() {
+	if (!unknownTitle) return;
+	const uint32_t more = unknownWaiting.size();
+	if (more == 0) { lv_label_set_text(unknownTitle, "Select category for this nut"); return; }
+	lv_label_set_text_fmt(unknownTitle, "Select category for this nut (+%u more)", (unsigned)more);
+}
+
+// Prompts are discrete events: one on screen, the rest queued with their nuts and shown in turn
+static void showUnknownPrompt(const NutRef& nut) {
+	if (!unknownOverlay) { unknownShown = nut; showUnknownNow(); return; }
+	if (!unknownWaiting.push(nut)) Serial.println("[UI] prompt dropped: queue full (nut stays Unknown)");
+	setUnknownTitle();
 }
 
 static void showUnknownNow() {
@@ -135,9 +220,9 @@ static void showUnknownNow() {
 	lv_obj_set_style_radius(card, 10, 0);
 	lv_obj_align(card, LV_ALIGN_CENTER, 0, 0);
 
-	lv_obj_t* title = lv_label_create(card);
-	lv_label_set_text(title, "Select category for this nut");
-	lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 0);
+	unknownTitle = lv_label_create(card);
+	setUnknownTitle();
+	lv_obj_align(unknownTitle, LV_ALIGN_TOP_MID, 0, 0);
 
 	lv_obj_t* grid = lv_obj_create(card);
 	lv_obj_remove_style_all(grid);
@@ -157,16 +242,22 @@ static void showUnknownNow() {
 }
 
 void uiFacadePoll() {
-	bool doPerc = false, doBatch = false, doUnknown = false;
-	int a=0, s=0, r=0, m=0; bool pass=false;
-
-	portENTER_CRITICAL(&uiMux);
-	if (pendPerc)  { a=pendA; s=pendS; r=pendR; m=pendM; pendPerc=false;  doPerc=true; }
-	if (pendBatch) { pass=pendBatchPass;           pendBatch=false; doBatch=true; }
-	if (pendUnknown){                         pendUnknown=false; doUnknown=true; }
-	portEXIT_CRITICAL(&uiMux);
-
-	if (doPerc)  uiFacadeSetPercentages(a, s, r, m);
-	if (doBatch) uiFacadeSetBatchResult(pass);
-	if (doUnknown) showUnknownNow();
+	UiCommand cmd;
+	while (uiQueue.pop(cmd)) {
+		switch (cmd.type) {
+			case UiCmdType::Percentages: {
+				const uint32_t v = percSlot.take();
+				uiFacadeSetPercentages(v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24);
+				break;
+			}
+			case UiCmdType::BatchResult:   uiFacadeSetBatchResult(cmd.arg != 0); break;
+			case UiCmdType::ClearBatch:    uiFacadeClearBatchResult(); break;
+			case UiCmdType::UnknownPrompt: showUnknownPrompt(cmd.nut); break;
+			case UiCmdType::Flash:         alertFlash((NutClass)cmd.arg); break;
+			case UiCmdType::Redraw:        lv_obj_invalidate(lv_screen_active()); break;
+			case UiCmdType::Trace:         traceViewRefresh(); break;
+			case UiCmdType::LogError:      uiFacadeSetLogError(); break;
+			default: break;
+		}
+	}
 }
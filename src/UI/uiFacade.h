@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include "app/sessionManager.h"
+#include "UI/uiQueue.h"
 
 extern "C" {
 	#include "UI/ui.h"
@@ -8,20 +9,36 @@ extern "C" {
 	#include <lvgl.h>
 }
 
-// init + immediate setters (LVGL thread only)
+// init + immediate setters (LVGL task only, or setup() before lvglTaskBegin())
 void uiFacadeInit();	// loads uic_Screen1 and logs pointers
 void uiFacadeSetPercentages(int api, int seconds, int rashi, int mangala);
 void uiFacadeSetBatchResult(bool pass);
 void uiFacadeClearBatchResult();
+void uiFacadeSetLogError();
 
-// cross-task posting (safe from WebServer handlers)
+// cross-task posting (safe from any task; wakes the LVGL task). Everything goes through
+// one bounded MPSC queue: percentages coalesce, discrete commands are kept in order and
+// only lost (and counted) if the queue is full.
+bool uiFacadePostCommand(UiCmdType type, uint8_t arg = 0);
 void uiFacadePostPercentages(int api, int seconds, int rashi, int mangala);
 void uiFacadePostBatchResult(bool pass);
+void uiFacadePostClearBatchResult();
+void uiFacadePostRedraw();		// full-screen repaint (display benchmarks)
+void uiFacadePostLogError();	// nuts are no longer being saved: say so in the result label
 
-// Apply posted updates on LVGL thread
+// posted/coalesced: percentage posts, and how many were folded into an update that was
+// already queued. dropped: commands of any type refused by a full queue. pickRefused:
+// Unknown picks the commit ring could not take (the prompt stays up for another tap).
+struct UiFacadeStats { uint32_t posted; uint32_t coalesced; uint32_t dropped; uint32_t highWater; uint32_t pickRefused; };
+UiFacadeStats uiFacadeGetStats();
+
+// Drain the command queue (LVGL task)
 void uiFacadePoll();
 
-// Unknown category flow
-typedef void (*UnknownCommitFn)(NutClass chosen);
+// Unknown category flow: each prompt carries the nut it was raised for; the pick is queued
+// by the LVGL task with that reference and handed to 'fn' by uiFacadePollCommits(), so
+// session writes never run on the render task and a late pick still lands on its own nut
+typedef void (*UnknownCommitFn)(NutClass chosen, const NutRef& nut);
 void uiFacadeRegisterUnknownCommit(UnknownCommitFn fn);
-void uiFacadePostShowUnknownPrompt();	// call from HTTP thread to show modal
+void uiFacadePostShowUnknownPrompt(const NutRef& nut);	// any task: queue a prompt for 'nut'
+void uiFacadePollCommits();				// loop(): deliver queued picks
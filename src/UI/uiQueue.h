@@ -0,0 +1,114 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "app/nutClass.h"
+
+/* Bounded lock-free multi-producer / single-consumer queue (header-only)
+ * - Any task may push(); only the LVGL task pops
+ * - Each cell carries a sequence number (D. Vyukov's bounded queue): a producer claims a
+ *   slot with one CAS on the head, fills it, then publishes it by bumping the cell's seq;
+ *   the consumer never touches the head, and a full queue fails fast instead of blocking
+ * - N must be a power of two
+ */
+
+template <typename T, size_t N>
+class MpscQueue {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscQueue size must be a power of two");
+
+public:
+	MpscQueue() {
+		for (uint32_t i = 0; i < N; ++i) _cell[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	// Producer side (any task). Returns false if the queue is full.
+	bool push(const T& v) {
+		uint32_t pos = _head.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell& c = _cell[pos & (N - 1)];
+			const int32_t dif = (int32_t)(c.seq.load(std::memory_order_acquire) - pos);
+			if (dif == 0) {
+				if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					c.v = v;
+					c.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+				// lost the race: 'pos' was reloaded by the CAS, try the next slot
+			} else if (dif < 0) {
+				return false;	// the consumer has not freed this lap's slot yet
+			} else {
+				pos = _head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Consumer side (one task). Returns false if empty or the next slot is still being filled.
+	bool pop(T& out) {
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+		Cell& c = _cell[tail & (N - 1)];
+		if ((int32_t)(c.seq.load(std::memory_order_acquire) - (tail + 1)) < 0) return false;
+		out = c.v;
+		c.seq.store(tail + N, std::memory_order_release);
+		_tail.store(tail + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Approximate fill level (exact when producers are idle); readable from any task
+	uint32_t size() const {
+		return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+	}
+	static constexpr size_t capacity() { return N; }
+
+private:
+	struct Cell {
+		std::atomic<uint32_t> seq;
+		T v;
+	};
+	Cell _cell[N];
+	alignas(64) std::atomic<uint32_t> _head{0};
+	alignas(64) std::atomic<uint32_t> _tail{0};
+};
+
+/* Latest-value slot for a command whose payload only matters as its newest value:
+ * producers overwrite the value, and only the first post since the consumer last took
+ * it asks for a command to be queued; later posts ride along with that one
+ */
+class CoalescingSlot {
+public:
+	// Any task. True if the caller must queue the command; false if one is outstanding.
+	bool post(uint32_t v) {
+		_value.store(v);
+		return !_queued.exchange(true);
+	}
+	// The command could not be queued: let the next post() try again
+	void cancel() { _queued.store(false); }
+	// Consumer, on dequeuing the command. The flag clears before the read, so a post
+	// racing with this one queues a fresh command rather than being lost.
+	uint32_t take() {
+		_queued.store(false);
+		return _value.load();
+	}
+
+private:
+	std::atomic<uint32_t> _value{0};
+	std::atomic<bool>     _queued{false};
+};
+
+/* UI commands: every cross-task change to the screen goes through one MpscQueue */
+enum class UiCmdType : uint8_t {
+	Percentages,	// payload lives in the coalescing slot, see uiFacadePostPercentages()
+	BatchResult,	// arg: 1 = pass, 0 = fail
+	ClearBatch,
+	UnknownPrompt,	// nut: the record the operator's pick applies to
+	Flash,			// arg: NutClass
+	Redraw,
+	Trace,			// coalesced by traceView, see traceViewRefresh()
+	LogError,		// the session log stopped accepting nuts
+	Count
+};
+
+struct UiCommand {
+	UiCmdType type;
+	uint8_t   arg;
+	NutRef    nut;
+};
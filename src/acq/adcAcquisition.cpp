@@ -0,0 +1,91 @@
+#include "adcAcquisition.h"
+#include "sampleRing.h"
+#include "app/metrics.h"
+
+// Pin the acquisition task away from the Arduino loop (LVGL + HTTP run on core 1)
+#ifndef ADC_ACQ_CORE
+#define ADC_ACQ_CORE		0
+#endif
+#ifndef ADC_ACQ_PRIO
+#define ADC_ACQ_PRIO		(configMAX_PRIORITIES - 1)
+#endif
+#ifndef ADC_ACQ_STACK
+#define ADC_ACQ_STACK		4096
+#endif
+#ifndef ADC_ACQ_RING_LEN
+#define ADC_ACQ_RING_LEN	1024	// ~512 ms of headroom at 2 kSPS (power of two)
+#endif
+
+static ADS1220_WE*   adcDev = nullptr;
+static TaskHandle_t  acqTask = nullptr;
+
+// Acquisition task -> processing: lock-free, never blocks the producer
+static SampleRing<AdcSample, ADC_ACQ_RING_LEN> acqRing;
+
+static volatile uint32_t drdyStampUs = 0;
+
+// ---- DRDY falling edge: stamp + wake the task, nothing else ----
+static void IRAM_ATTR drdyIsr() {
+	drdyStampUs = micros();
+	BaseType_t woken = pdFALSE;
+	vTaskNotifyGiveFromISR(acqTask, &woken);
+	if (woken) portYIELD_FROM_ISR();
+}
+
+static void acqTaskFn(void*) {
+	for (;;) {
+		// Count > 1 means DRDY fired again before we got to read the previous result
+		uint32_t edges = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		if (edges > 1) metricAdcMissed.inc(edges - 1);
+
+		AdcSample s;
+		s.tUs  = drdyStampUs;
+		s.code = adcDev->getRawData();	// continuous mode: DRDY already low, reads immediately
+
+		if (acqRing.push(s)) metricAdcSamples.inc();	// overflow is counted by the ring
+	}
+}
+
+bool adcAcqBegin(ADS1220_WE& adc, uint8_t drdyPin) {
+	if (acqTask) return true;
+
+	if (!adc.init()) {
+		Serial.println("[ACQ] ADS1220 not responding");
+		return false;
+	}
+	adc.setOperatingMode(ADS1220_TURBO_MODE);	// turbo doubles the rate: LVL_6 -> 2000 SPS
+	adc.setDataRate(ADS1220_DR_LVL_6);
+	adc.setConversionMode(ADS1220_CONTINUOUS);
+	adcDev = &adc;
+
+	if (xTaskCreatePinnedToCore(acqTaskFn, "adcAcq", ADC_ACQ_STACK, nullptr,
+	                            ADC_ACQ_PRIO, &acqTask, ADC_ACQ_CORE) != pdPASS) {
+		Serial.println("[ACQ] task create failed");
+		return false;
+	}
+
+	pinMode(drdyPin, INPUT);
+	attachInterrupt(digitalPinToInterrupt(drdyPin), drdyIsr, FALLING);
+	adc.start();	// first conversion; continuous mode keeps DRDY pulsing from here
+
+	Serial.printf("[ACQ] ADS1220 continuous @2kSPS, task on core %d\n", ADC_ACQ_CORE);
+	return true;
+}
+
+bool adcAcqRead(AdcSample& out) {
+	return acqRing.pop(out);
+}
+
+size_t adcAcqReadBulk(AdcSample* out, size_t maxCount) {
+	return acqRing.popBulk(out, maxCount);
+}
+
+AdcAcqStats adcAcqGetStats() {
+	AdcAcqStats st;
+	st.samples = metricAdcSamples.value();
+	st.missed  = metricAdcMissed.value();
+	st.dropped = acqRing.overflows();
+	st.highWater = acqRing.highWater();
+	st.capacity  = acqRing.capacity();
+	return st;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <Arduino.h>
+#include <ADS1220_WE.h>
+
+// ADS1220 wiring. GPIO6-11 belong to the SPI flash on ESP32 modules (DevKit V1: CLK, SD0-SD3,
+// CMD); driving one of them as CS or using it for DRDY can crash the chip or corrupt flash.
+#ifndef ADS1220_CS_PIN
+#define ADS1220_CS_PIN		26
+#endif
+#ifndef ADS1220_DRDY_PIN
+#define ADS1220_DRDY_PIN	5
+#endif
+static_assert(ADS1220_CS_PIN < 6 || ADS1220_CS_PIN > 11, "ADS1220_CS_PIN is an SPI flash pin (GPIO6-11)");
+static_assert(ADS1220_DRDY_PIN < 6 || ADS1220_DRDY_PIN > 11, "ADS1220_DRDY_PIN is an SPI flash pin (GPIO6-11)");
+
+// The ADS1220 gets its own SPI host. The display (UI/lvglDisplay.cpp, TFT_eSPI on VSPI)
+// keeps its bus through each DMA strip, which would hold conversions off on a shared bus.
+// MISO stays off GPIO12 (HSPI's default), a strapping pin that sets the flash voltage.
+#ifndef ADS1220_SPI_HOST
+#define ADS1220_SPI_HOST	HSPI
+#endif
+#ifndef ADS1220_SCK_PIN
+#define ADS1220_SCK_PIN		14
+#endif
+#ifndef ADS1220_MISO_PIN
+#define ADS1220_MISO_PIN	27
+#endif
+#ifndef ADS1220_MOSI_PIN
+#define ADS1220_MOSI_PIN	13
+#endif
+static_assert((ADS1220_SCK_PIN < 6 || ADS1220_SCK_PIN > 11) && (ADS1220_MISO_PIN < 6 || ADS1220_MISO_PIN > 11)
+              && (ADS1220_MOSI_PIN < 6 || ADS1220_MOSI_PIN > 11), "ADS1220 SPI pin is an SPI flash pin (GPIO6-11)");
+
+// One ADS1220 conversion, timestamped at the DRDY falling edge
+struct AdcSample {
+	uint32_t tUs;	// micros() captured in the DRDY ISR
+	int32_t  code;	// sign-extended 24-bit conversion result
+};
+
+struct AdcAcqStats {
+	uint32_t samples;	// conversions read and queued
+	uint32_t missed;	// DRDY edges that fired while the task was still busy
+	uint32_t dropped;	// samples read but not queued (ring full, consumer too slow)
+	uint32_t highWater;	// deepest ring fill level seen so far
+	uint32_t capacity;	// ring size in samples
+};
+
+// Configure the ADS1220 for continuous turbo-mode conversions (2 kSPS) and start the
+// acquisition task pinned to ADC_ACQ_CORE. The task wakes on the DRDY falling edge.
+bool adcAcqBegin(ADS1220_WE& adc, uint8_t drdyPin);
+
+// Consumer side of the sample ring. Exactly ONE task may read (single consumer).
+bool adcAcqRead(AdcSample& out);
+size_t adcAcqReadBulk(AdcSample* out, size_t maxCount);
+
+AdcAcqStats adcAcqGetStats();
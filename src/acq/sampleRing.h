@@ -0,0 +1,81 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/* Lock-free single-producer / single-consumer ring (header-only, no Arduino deps)
+ * - One producer task (e.g. ADC acquisition) calls push(); one consumer calls pop()
+ * - N must be a power of two; usable capacity is N (indices run free and wrap)
+ * - Producer and consumer indices sit on separate cache lines (no false sharing)
+ * - overflows(): pushes rejected because the ring was full
+ * - highWater(): deepest fill level the producer has seen (use it to size N)
+ */
+
+#ifndef SAMPLE_RING_ALIGN
+#define SAMPLE_RING_ALIGN 64
+#endif
+
+template <typename T, size_t N>
+class SampleRing {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing size must be a power of two");
+
+public:
+	// Producer side. Returns false (and counts an overflow) if full.
+	bool push(const T& v) {
+		const uint32_t head = _head.load(std::memory_order_relaxed);
+		const uint32_t tail = _tail.load(std::memory_order_acquire);
+		const uint32_t used = head - tail;
+		if (used >= N) {
+			_overflows.store(_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return false;
+		}
+		_buf[head & (N - 1)] = v;
+		_head.store(head + 1, std::memory_order_release);
+
+		if (used + 1 > _highWater.load(std::memory_order_relaxed))
+			_highWater.store(used + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Consumer side. Returns false if empty.
+	bool pop(T& out) {
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+		const uint32_t head = _head.load(std::memory_order_acquire);
+		if (head == tail) return false;
+		out = _buf[tail & (N - 1)];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side: copy out up to maxCount items in one go. Returns how many.
+	size_t popBulk(T* out, size_t maxCount) {
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+		const uint32_t head = _head.load(std::memory_order_acquire);
+		size_t n = head - tail;
+		if (n > maxCount) n = maxCount;
+		for (size_t i = 0; i < n; ++i) out[i] = _buf[(tail + i) & (N - 1)];
+		_tail.store(tail + (uint32_t)n, std::memory_order_release);
+		return n;
+	}
+
+	// Approximate from any thread; exact from either endpoint
+	size_t size() const {
+		return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+	}
+	bool empty() const { return size() == 0; }
+	static constexpr size_t capacity() { return N; }
+
+	uint32_t overflows() const { return _overflows.load(std::memory_order_relaxed); }
+	uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+private:
+	// producer-owned
+	alignas(SAMPLE_RING_ALIGN) std::atomic<uint32_t> _head{0};
+	std::atomic<uint32_t> _overflows{0};
+	std::atomic<uint32_t> _highWater{0};
+
+	// consumer-owned
+	alignas(SAMPLE_RING_ALIGN) std::atomic<uint32_t> _tail{0};
+
+	alignas(SAMPLE_RING_ALIGN) T _buf[N];
+};
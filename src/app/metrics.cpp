@@ -0,0 +1,186 @@
+#include "metrics.h"
+#include "acq/adcAcquisition.h"
+#include "app/nutPipeline.h"
+#include "app/traceTap.h"
+#include "UI/lvglDisplay.h"
+#include "UI/uiFacade.h"
+#include "UI/alertSystem.h"
+#include "UI/touchInput.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static Metric* head = nullptr;
+static Metric* tail = nullptr;
+static portMUX_TYPE histMux = portMUX_INITIALIZER_UNLOCKED;
+
+Metric::Metric(const char* name, const char* help, const char* labels, const char* type)
+	: _name(name), _help(help), _labels(labels), _type(type) {
+	if (tail) tail->_next = this;
+	else      head = this;
+	tail = this;
+}
+
+// name[suffix]{labels,extra} value
+void Metric::writeSample(Print& out, const char* suffix, const char* extraLabel, uint64_t v) const {
+	out.print(_name);
+	if (suffix) out.print(suffix);
+	if (_labels || extraLabel) {
+		out.print("{");
+		if (_labels) out.print(_labels);
+		if (_labels && extraLabel) out.print(",");
+		if (extraLabel) out.print(extraLabel);
+		out.print("}");
+	}
+	char num[24];
+	snprintf(num, sizeof(num), " %llu\n", (unsigned long long)v);
+	out.print(num);
+}
+
+void MetricCounter::write(Print& out) const {
+	writeSample(out, nullptr, nullptr, value());
+}
+
+void MetricFn::write(Print& out) const {
+	writeSample(out, nullptr, nullptr, _fn(_arg));
+}
+
+/* ---- histogram ---- */
+// Bucket i holds values <= 2^(MIN_EXP + i): ceil(log2(us)) - MIN_EXP, clamped to +Inf
+static inline uint32_t bucketOf(uint32_t us) {
+	if (us <= (1u << METRIC_HIST_MIN_EXP)) return 0;
+	const uint32_t b = (32 - __builtin_clz(us - 1)) - METRIC_HIST_MIN_EXP;
+	return b < METRIC_HIST_BUCKETS ? b : METRIC_HIST_BUCKETS;
+}
+
+void MetricHistogram::observe(uint32_t us) {
+	const uint32_t b = bucketOf(us);
+	portENTER_CRITICAL(&histMux);
+	_bucket[b]++;
+	_sum += us;
+	_count++;
+	portEXIT_CRITICAL(&histMux);
+}
+
+void MetricHistogram::write(Print& out) const {
+	uint32_t bucket[METRIC_HIST_BUCKETS + 1];
+	uint64_t sum;
+	uint32_t count;
+	portENTER_CRITICAL(&histMux);
+	memcpy(bucket, _bucket, sizeof(bucket));
+	sum = _sum;
+	count = _count;
+	portEXIT_CRITICAL(&histMux);
+
+	// Prometheus buckets are cumulative
+	uint32_t acc = 0;
+	char le[20];
+	for (uint32_t i = 0; i < METRIC_HIST_BUCKETS; ++i) {
+		acc += bucket[i];
+		snprintf(le, sizeof(le), "le=\"%lu\"", (unsigned long)(1ul << (METRIC_HIST_MIN_EXP + i)));
+		writeSample(out, "_bucket", le, acc);
+	}
+	writeSample(out, "_bucket", "le=\"+Inf\"", count);
+	writeSample(out, "_sum", nullptr, sum);
+	writeSample(out, "_count", nullptr, count);
+}
+
+/* ---- scrape-time readers ---- */
+static uint32_t readAdcDropped(const char*)    { return adcAcqGetStats().dropped; }
+static uint32_t readPipeWindows(const char*)   { return nutPipelineGetStats().windows; }
+static uint32_t readPipeDropped(const char*)   { return nutPipelineGetStats().dropped; }
+static uint32_t readFreeHeap(const char*)      { return heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+static uint32_t readLargestBlock(const char*)  { return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT); }
+static uint32_t readMinFreeHeap(const char*)   { return heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT); }
+static uint32_t readDrawBufLines(const char*)  { return lvglDisplayBufLines(); }
+static uint32_t readDrawBufs(const char*)      { return lvglDisplayDoubleBuffered() ? 2 : 1; }
+static uint32_t readSpiHz(const char*)         { return lvglDisplaySpiHz(); }
+static uint32_t readUiCoalesced(const char*)   { return uiFacadeGetStats().coalesced; }
+static uint32_t readUiDropped(const char*)     { return uiFacadeGetStats().dropped; }
+static uint32_t readUiHighWater(const char*)   { return uiFacadeGetStats().highWater; }
+static uint32_t readUiPickRefused(const char*) { return uiFacadeGetStats().pickRefused; }
+static uint32_t readFlashDropped(const char*)  { return alertGetStats().dropped; }
+static uint32_t readTraceTorn(const char*)     { return traceTapGetStats().torn; }
+static uint32_t readTouchErrors(const char*)   { return touchInputGetStats().i2cErrors; }
+static uint32_t readTouchDropped(const char*)  { return touchInputGetStats().dropped; }
+
+// ESP-IDF reports stack high-water marks in bytes; a task that is not running reads 0
+static uint32_t readStackFree(const char* task) {
+	TaskHandle_t h = xTaskGetHandle(task);
+	return h ? (uint32_t)uxTaskGetStackHighWaterMark(h) : 0;
+}
+
+/* ---- registry (exposition order) ---- */
+MetricCounter metricAdcSamples("nc_adc_samples_total", "ADC samples pushed by the acquisition task");
+MetricCounter metricAdcMissed ("nc_adc_missed_total", "DRDY edges the acquisition task did not service");
+static MetricFn metricAdcDropped("nc_adc_dropped_total", "Samples lost to a full acquisition ring",
+                                 nullptr, "counter", readAdcDropped);
+
+static MetricFn metricPipeWindows("nc_pipeline_windows_total", "Nut windows segmented", nullptr, "counter", readPipeWindows);
+static MetricFn metricPipeDropped("nc_pipeline_dropped_total", "Nut windows dropped for lack of a slot", nullptr, "counter", readPipeDropped);
+
+MetricCounter metricNuts[5] = {
+	{ "nc_nuts_total", "Nuts recorded by class", "class=\"api\"" },
+	{ "nc_nuts_total", "Nuts recorded by class", "class=\"seconds\"" },
+	{ "nc_nuts_total", "Nuts recorded by class", "class=\"rashi\"" },
+	{ "nc_nuts_total", "Nuts recorded by class", "class=\"mangala\"" },
+	{ "nc_nuts_total", "Nuts recorded by class", "class=\"unknown\"" },
+};
+
+MetricCounter metricFlashBytes[3] = {
+	{ "nc_flash_bytes_written_total", "Bytes written to flash", "file=\"log\"" },
+	{ "nc_flash_bytes_written_total", "Bytes written to flash", "file=\"json\"" },
+	{ "nc_flash_bytes_written_total", "Bytes written to flash", "file=\"index\"" },
+};
+
+MetricHistogram metricFsOpUs[3] = {
+	{ "nc_fs_op_microseconds", "Flash write operation latency", "file=\"log\"" },
+	{ "nc_fs_op_microseconds", "Flash write operation latency", "file=\"json\"" },
+	{ "nc_fs_op_microseconds", "Flash write operation latency", "file=\"index\"" },
+};
+
+MetricHistogram metricHttpUs("nc_http_handler_microseconds", "HTTP handler latency");
+MetricHistogram metricLvglFrameUs("nc_lvgl_frame_microseconds", "LVGL refresh (render + flush) time");
+MetricCounter metricLvglPixels("nc_lvgl_pixels_flushed_total", "Pixels handed to the display flush");
+MetricCounter metricLvglSpiBytes("nc_lvgl_spi_bytes_total", "Bytes queued to the display DMA (utilisation = rate * 8 / spi_hz)");
+MetricHistogram metricLvglFlushWaitUs("nc_lvgl_flush_wait_microseconds", "CPU time blocked waiting for display DMA");
+static MetricFn metricDrawBufLines("nc_lvgl_draw_buf_lines", "Lines per draw buffer", nullptr, "gauge", readDrawBufLines);
+static MetricFn metricDrawBufs("nc_lvgl_draw_buffers", "Draw buffers (2 = render overlaps DMA)", nullptr, "gauge", readDrawBufs);
+static MetricFn metricSpiHz("nc_lvgl_spi_hz", "Display SPI clock", nullptr, "gauge", readSpiHz);
+
+static MetricFn metricUiCoalesced("nc_ui_percent_coalesced_total", "Percentage updates folded into one already queued", nullptr, "counter", readUiCoalesced);
+static MetricFn metricUiDropped  ("nc_ui_queue_dropped_total", "UI commands refused by a full queue", nullptr, "counter", readUiDropped);
+static MetricFn metricUiHighWater("nc_ui_queue_high_water", "Deepest UI command queue fill seen", nullptr, "gauge", readUiHighWater);
+static MetricFn metricUiPickRefused("nc_ui_unknown_pick_refused_total", "Unknown picks refused by a full commit ring (prompt kept up)", nullptr, "counter", readUiPickRefused);
+static MetricFn metricFlashDropped("nc_alert_flash_dropped_total", "Class flashes refused by a full UI queue", nullptr, "counter", readFlashDropped);
+static MetricFn metricTraceTorn("nc_trace_torn_reads_total", "Scope refreshes skipped because the producer kept overwriting the trace", nullptr, "counter", readTraceTorn);
+
+MetricHistogram metricTouchLatencyUs("nc_touch_latency_microseconds", "Touch sample to LVGL indev read");
+static MetricFn metricTouchErrors ("nc_touch_i2c_errors_total", "Touch samples skipped on an I2C error", nullptr, "counter", readTouchErrors);
+static MetricFn metricTouchDropped("nc_touch_dropped_total", "Touch points refused by a full ring", nullptr, "counter", readTouchDropped);
+
+static MetricFn metricHeapFree   ("nc_heap_free_bytes", "Free 8-bit heap", nullptr, "gauge", readFreeHeap);
+static MetricFn metricHeapMin    ("nc_heap_min_free_bytes", "Lowest free 8-bit heap since boot", nullptr, "gauge", readMinFreeHeap);
+static MetricFn metricHeapLargest("nc_heap_largest_block_bytes", "Largest allocatable 8-bit block", nullptr, "gauge", readLargestBlock);
+
+static MetricFn metricStack[6] = {
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"adcAcq\"",     "gauge", readStackFree, "adcAcq" },
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"nutPipe\"",    "gauge", readStackFree, "nutPipe" },
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"lvgl\"",       "gauge", readStackFree, "lvgl" },
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"touch\"",      "gauge", readStackFree, "touch" },
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"loopTask\"",   "gauge", readStackFree, "loopTask" },
+	{ "nc_task_stack_free_bytes", "Stack high-water mark (bytes never used)", "task=\"async_tcp\"",  "gauge", readStackFree, "async_tcp" },
+};
+
+/* ---- exposition ---- */
+void metricsWrite(Print& out) {
+	const char* family = nullptr;
+	for (const Metric* m = head; m; m = m->next()) {
+		if (!family || strcmp(family, m->name()) != 0) {	// HELP/TYPE once per family
+			family = m->name();
+			out.print("# HELP "); out.print(family); out.print(" "); out.print(m->help()); out.print("\n");
+			out.print("# TYPE "); out.print(family); out.print(" "); out.print(m->type()); out.print("\n");
+		}
+		m->write(out);
+	}
+}
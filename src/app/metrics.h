@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+
+/* Metrics registry, exposed as Prometheus text at GET /metrics
+ *
+ * - Metrics are globals defined in metrics.cpp; constructing one appends it to the
+ *   registry, so exposition order == definition order (families stay together)
+ * - MetricCounter::inc() is one relaxed atomic add: safe from any task, cheap enough
+ *   for the acquisition path
+ * - MetricHistogram has fixed power-of-two buckets (µs): the bucket is found with one
+ *   CLZ, the update is a short spinlock section (not for ISRs)
+ * - MetricFn reads a value at scrape time (heap, stack high-water, existing stats)
+ */
+
+#ifndef METRIC_HIST_MIN_EXP
+#define METRIC_HIST_MIN_EXP		4		// first bucket: <= 16 µs
+#endif
+#ifndef METRIC_HIST_BUCKETS
+#define METRIC_HIST_BUCKETS		17		// last finite bucket: <= 2^20 µs (~1 s), then +Inf
+#endif
+
+class Metric {
+public:
+	Metric(const char* name, const char* help, const char* labels, const char* type);
+	virtual ~Metric() {}
+	virtual void write(Print& out) const = 0;
+
+	const char* name() const { return _name; }
+	const char* help() const { return _help; }
+	const char* type() const { return _type; }
+	const Metric* next() const { return _next; }
+
+protected:
+	void writeSample(Print& out, const char* suffix, const char* extraLabel, uint64_t v) const;
+
+	const char* _name;
+	const char* _help;
+	const char* _labels;	// e.g. class="Api" (no braces) or nullptr
+	const char* _type;
+	Metric*     _next = nullptr;
+};
+
+class MetricCounter : public Metric {
+public:
+	MetricCounter(const char* name, const char* help, const char* labels = nullptr)
+		: Metric(name, help, labels, "counter") {}
+	inline void inc(uint32_t n = 1) { _v.fetch_add(n, std::memory_order_relaxed); }
+	uint32_t value() const { return _v.load(std::memory_order_relaxed); }
+	void write(Print& out) const override;
+
+private:
+	std::atomic<uint32_t> _v{0};
+};
+
+class MetricHistogram : public Metric {
+public:
+	MetricHistogram(const char* name, const char* help, const char* labels = nullptr)
+		: Metric(name, help, labels, "histogram") {}
+	void observe(uint32_t us);
+	void write(Print& out) const override;
+
+private:
+	uint32_t _bucket[METRIC_HIST_BUCKETS + 1] = {};	// last: +Inf
+	uint64_t _sum = 0;
+	uint32_t _count = 0;
+};
+
+typedef uint32_t (*MetricReadFn)(const char* arg);
+
+class MetricFn : public Metric {
+public:
+	MetricFn(const char* name, const char* help, const char* labels, const char* type,
+	         MetricReadFn fn, const char* arg = nullptr)
+		: Metric(name, help, labels, type), _fn(fn), _arg(arg) {}
+	void write(Print& out) const override;
+
+private:
+	MetricReadFn _fn;
+	const char*  _arg;
+};
+
+// Hot-path metrics (see metrics.cpp for the full list)
+extern MetricCounter metricAdcSamples;
+extern MetricCounter metricAdcMissed;
+extern MetricCounter metricNuts[5];			// Api, Seconds, Rashi, Mangala, Unknown
+extern MetricCounter metricFlashBytes[3];	// log, json, index
+extern MetricHistogram metricFsOpUs[3];		// log, json, index
+extern MetricHistogram metricHttpUs;
+extern MetricHistogram metricLvglFrameUs;
+extern MetricCounter metricLvglPixels;
+extern MetricCounter metricLvglSpiBytes;
+extern MetricHistogram metricLvglFlushWaitUs;
+extern MetricHistogram metricTouchLatencyUs;
+
+enum : uint8_t { METRIC_FS_LOG = 0, METRIC_FS_JSON = 1, METRIC_FS_INDEX = 2 };
+
+// Prometheus text exposition format 0.0.4
+void metricsWrite(Print& out);
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+
+enum class NutClass : uint8_t { Api=0, Seconds=1, Rashi=2, Mangala=3, Unknown=255 };
+
+// One logged nut, for an edit that arrives later (Unknown prompt picks): its record offset
+// in nuts.bin plus the session it was logged in, so a reference outliving its session is
+// refused rather than applied to whatever sits at that offset now
+struct NutRef {
+	uint32_t recOffset;		// 0 = none
+	uint16_t session;		// SessionManager::sessionTag() at the time
+};
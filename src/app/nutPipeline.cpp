@@ -0,0 +1,129 @@
+#include "nutPipeline.h"
+#include "acq/adcAcquisition.h"
+#include "acq/sampleRing.h"
+#include "app/traceTap.h"
+
+#ifndef NUT_PIPE_CORE
+#define NUT_PIPE_CORE		0
+#endif
+#ifndef NUT_PIPE_PRIO
+#define NUT_PIPE_PRIO		5
+#endif
+#ifndef NUT_PIPE_STACK
+#define NUT_PIPE_STACK		4096
+#endif
+#ifndef NUT_PIPE_SLOTS
+#define NUT_PIPE_SLOTS		4	// windows in flight between the task and loop() (power of two)
+#endif
+
+static NutSegmenter segmenter;
+static const CentroidClassifier classifier(kNutDefaultModel);
+static TaskHandle_t pipeTask = nullptr;
+
+// Fixed detection pool: free slots flow task <- loop, ready slots flow task -> loop
+static NutDetection slots[NUT_PIPE_SLOTS];
+static SampleRing<uint8_t, NUT_PIPE_SLOTS> freeSlots;
+static SampleRing<uint8_t, NUT_PIPE_SLOTS> readySlots;
+
+static NutDetectionFn sink = nullptr;
+
+static volatile uint32_t statSamples = 0;
+static volatile uint32_t statWindows = 0;
+static volatile uint32_t statDropped = 0;
+static volatile uint32_t statCyclesPerSample = 0;
+static volatile uint32_t statRefMismatch = 0;
+static volatile uint32_t statClassifyCycles = 0;
+static volatile uint32_t statUnknowns = 0;
+
+static void publishWindow(const NutWindow& w) {
+	uint8_t idx;
+	if (!freeSlots.pop(idx)) { statDropped = statDropped + 1; return; }
+
+	NutDetection& det = slots[idx];
+	NutWindow& dst = det.window;
+	dst.tStartUs   = w.tStartUs;
+	dst.tEndUs     = w.tEndUs;
+	dst.baseline   = w.baseline;
+	dst.count      = w.count;
+	dst.triggerIdx = w.triggerIdx;
+	dst.truncated  = w.truncated;
+	memcpy(dst.samples, w.samples, w.count * sizeof(w.samples[0]));
+
+	const uint32_t c0 = ESP.getCycleCount();
+	nutFeaturesExtract(dst, det.features);
+	det.featureCycles = ESP.getCycleCount() - c0;
+	if (dst.count) statCyclesPerSample = det.featureCycles / dst.count;
+
+#ifdef NUT_FEATURES_REFERENCE
+	NutFeaturesRef ref;
+	nutFeaturesReference(dst, ref);
+	if (!nutFeaturesMatchReference(det.features, ref)) {
+		statRefMismatch = statRefMismatch + 1;
+		Serial.printf("[PIPE] feature mismatch: peak %d/%.0f slope %d/%.5f zc %u/%d\n",
+			(int)det.features.peak, ref.peak, (int)det.features.decaySlopeQ15, ref.decaySlope,
+			(unsigned)det.features.zeroCrossings, ref.zeroCrossings);
+	}
+#endif
+
+	const uint32_t c1 = ESP.getCycleCount();
+	det.result = classifier.classify(det.features);
+	det.classifyCycles = ESP.getCycleCount() - c1;
+	statClassifyCycles = det.classifyCycles;
+	if (det.result.cls == NutClass::Unknown) statUnknowns = statUnknowns + 1;
+	traceTapWindow(dst, det.result.cls);
+
+	readySlots.push(idx);	// cannot overflow: slot count == ring capacity
+	statWindows = statWindows + 1;
+}
+
+static void pipeTaskFn(void*) {
+	AdcSample batch[64];
+	for (;;) {
+		const size_t n = adcAcqReadBulk(batch, 64);
+		if (n == 0) { vTaskDelay(1); continue; }
+
+		for (size_t i = 0; i < n; ++i) {
+			if (segmenter.push(batch[i].tUs, batch[i].code)) publishWindow(segmenter.window());
+			traceTapSample(batch[i].code, segmenter.baseline());
+		}
+		statSamples = statSamples + n;
+	}
+}
+
+void nutPipelineBegin(const NutSegmenterConfig& cfg) {
+	if (pipeTask) return;
+	segmenter.begin(cfg);
+	for (uint8_t i = 0; i < NUT_PIPE_SLOTS; ++i) freeSlots.push(i);
+
+	if (xTaskCreatePinnedToCore(pipeTaskFn, "nutPipe", NUT_PIPE_STACK, nullptr,
+	                            NUT_PIPE_PRIO, &pipeTask, NUT_PIPE_CORE) != pdPASS) {
+		Serial.println("[PIPE] task create failed");
+		return;
+	}
+	Serial.printf("[PIPE] segmenter thr=%d pre=%u post=%u -> max %u nuts/min @2kSPS\n",
+		(int)cfg.threshold, (unsigned)cfg.preTrigger, (unsigned)cfg.postTrigger,
+		(unsigned)segmenter.config().maxNutsPerMinute(2000));
+}
+
+void nutPipelineRegisterSink(NutDetectionFn fn) { sink = fn; }
+
+void nutPipelinePoll() {
+	uint8_t idx;
+	while (readySlots.pop(idx)) {
+		if (sink) sink(slots[idx]);
+		freeSlots.push(idx);
+	}
+}
+
+NutPipelineStats nutPipelineGetStats() {
+	NutPipelineStats st;
+	st.samples  = statSamples;
+	st.windows  = statWindows;
+	st.dropped  = statDropped;
+	st.baseline = segmenter.baseline();
+	st.featureCyclesPerSample = statCyclesPerSample;
+	st.referenceMismatches    = statRefMismatch;
+	st.classifyCycles         = statClassifyCycles;
+	st.unknowns               = statUnknowns;
+	return st;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+#include "dsp/nutSegmenter.h"
+#include "dsp/nutFeatures.h"
+#include "dsp/nutClassifier.h"
+
+// One segmented nut plus everything the processing task derived from it
+struct NutDetection {
+	NutWindow   window;
+	NutFeatures features;
+	uint32_t    featureCycles;	// CPU cycles spent in nutFeaturesExtract()
+	ClassifyResult result;		// Unknown when the model is not confident
+	uint32_t    classifyCycles;	// CPU cycles spent in the classifier
+};
+
+struct NutPipelineStats {
+	uint32_t samples;		// samples pulled from the acquisition ring
+	uint32_t windows;		// complete nut windows produced by the segmenter
+	uint32_t dropped;		// windows lost because every slot was still in use
+	int32_t  baseline;		// current segmenter baseline (ADC codes)
+	uint32_t featureCyclesPerSample;	// last window: feature kernel cost per sample
+	uint32_t classifyCycles;	// last window: classifier cost
+	uint32_t unknowns;		// windows the classifier routed to the operator
+	uint32_t referenceMismatches;	// only with -D NUT_FEATURES_REFERENCE
+};
+
+// Start the processing task: acquisition ring -> segmenter -> features -> classifier -> ready slots.
+void nutPipelineBegin(const NutSegmenterConfig& cfg = NutSegmenterConfig());
+
+// Completed detections are handed to this callback from nutPipelinePoll()
+typedef void (*NutDetectionFn)(const NutDetection& d);
+void nutPipelineRegisterSink(NutDetectionFn fn);
+
+// Call once per loop() on the thread that owns the session; delivers ready detections
+void nutPipelinePoll();
+
+NutPipelineStats nutPipelineGetStats();
@@ -0,0 +1,192 @@
+#include "sessionIndex.h"
+#include "fs/fsCompat.h"
+#include "fs/crc32.h"
+#include "app/metrics.h"
+#include <stddef.h>
+
+static const char* indexPath  = "/sessions/index.bin";
+static const char* headerPath = "/sessions/index.hdr";
+static const uint16_t SESSION_INDEX_VERSION = 2;
+
+static uint32_t headerCrc(const SessionIndexHeader& h) {
+	return crc32Update(0, &h, offsetof(SessionIndexHeader, crc));
+}
+
+uint32_t sessionIndexEntryCrc(const SessionIndexEntry& e) {
+	return crc32Update(0, &e, offsetof(SessionIndexEntry, crc));
+}
+
+static inline uint32_t entryPos(int32_t slot) { return (uint32_t)slot * sizeof(SessionIndexEntry); }
+
+void SessionIndex::applyState(SessionIndexHeader& h, int32_t slot, const SessionIndexEntry& e) {
+	if ((uint32_t)slot >= h.count) h.count = slot + 1;
+	if (e.state == SESSION_STATE_OPEN)                               h.openSlot = slot;
+	else if (e.state == SESSION_STATE_CLOSED && h.openSlot == slot) h.openSlot = SESSION_SLOT_NONE;
+}
+
+bool SessionIndex::begin(bool readOnly) {
+	_hdr = SessionIndexHeader{};
+	_readOnly = readOnly;
+	SessionIndexHeader h;
+	fs::File f = FSYS.open(headerPath, "r");
+	if (!f) { Serial.println("[INDEX] index.hdr missing"); return false; }
+	const bool got = f.read((uint8_t*)&h, sizeof(h)) == sizeof(h);
+	f.close();
+
+	f = FSYS.open(indexPath, "r");
+	const uint32_t size = f ? f.size() : 0;
+	if (!got || h.magic != SESSION_INDEX_MAGIC || h.version != SESSION_INDEX_VERSION
+	    || h.entrySize != sizeof(SessionIndexEntry) || h.crc != headerCrc(h) || !f
+	    || size < entryPos(h.count)) {
+		if (f) f.close();
+		Serial.println("[INDEX] index missing or corrupt");
+		return false;
+	}
+
+	// Roll forward an entry whose header update was lost: only the newest commit can be
+	// unfinished, so it is either the next slot or the open session's slot
+	SessionIndexEntry e;
+	const int32_t candidates[2] = { (int32_t)h.count, h.openSlot };
+	for (int32_t slot : candidates) {
+		if (slot == SESSION_SLOT_NONE || size < entryPos(slot + 1)) continue;
+		if (f.seek(entryPos(slot)) && f.read((uint8_t*)&e, sizeof(e)) == sizeof(e)
+		    && e.crc == sessionIndexEntryCrc(e) && e.seq == h.seq + 1) {
+			applyState(h, slot, e);
+			h.seq = e.seq;
+			h.crc = headerCrc(h);
+			Serial.printf("[INDEX] rolled forward slot %d\n", (int)slot);
+			f.close();
+			_hdr = h;
+			return _readOnly || writeHeader(h);	// persist it, so the next commit's seq follows on
+		}
+	}
+	f.close();
+	_hdr = h;
+	return true;
+}
+
+bool SessionIndex::writeHeader(const SessionIndexHeader& h) {
+	fs::File f = FSYS.open(headerPath, "w");
+	if (!f) return false;
+	const bool ok = f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h);
+	f.close();
+	metricFlashBytes[METRIC_FS_INDEX].inc(sizeof(h));
+	return ok;
+}
+
+bool SessionIndex::reset() {
+	if (_readOnly) return false;
+	_hdr = SessionIndexHeader{};
+	_hdr.magic     = SESSION_INDEX_MAGIC;
+	_hdr.version   = SESSION_INDEX_VERSION;
+	_hdr.entrySize = sizeof(SessionIndexEntry);
+	_hdr.openSlot  = SESSION_SLOT_NONE;
+	_hdr.crc       = headerCrc(_hdr);
+
+	fs::File f = FSYS.open(indexPath, "w");	// truncate (also drops a version 1 file)
+	if (!f) return false;
+	f.close();
+	return writeHeader(_hdr);
+}
+
+// Entry at its slot (tail for the open session), then the header; see sessionIndex.h
+bool SessionIndex::commit(int32_t slot, SessionIndexEntry* e) {
+	if (_readOnly) return false;
+	SessionIndexHeader h = _hdr;
+	h.seq++;
+	if (e) {
+		e->seq = h.seq;
+		e->crc = sessionIndexEntryCrc(*e);
+		applyState(h, slot, *e);
+	}
+	h.crc = headerCrc(h);
+
+	const uint32_t t0 = micros();
+	bool ok = true;
+	if (e) {
+		fs::File f = FSYS.open(indexPath, "r+");
+		ok = f && f.seek(entryPos(slot)) && f.write((const uint8_t*)e, sizeof(*e)) == sizeof(*e);
+		if (f) f.close();
+		metricFlashBytes[METRIC_FS_INDEX].inc(sizeof(*e));
+	}
+	ok = ok && writeHeader(h);
+	metricFsOpUs[METRIC_FS_INDEX].observe(micros() - t0);
+	if (ok) _hdr = h;
+	return ok;
+}
+
+int32_t SessionIndex::add(const char* id, uint8_t state, SessionIndexEntry* out) {
+	if (_hdr.magic != SESSION_INDEX_MAGIC && !reset()) return SESSION_SLOT_NONE;
+
+	SessionIndexEntry e = {};
+	strncpy(e.id, id, sizeof(e.id) - 1);
+	e.startEpoch = idToEpoch(id);
+	e.state = state;
+
+	const int32_t slot = (int32_t)_hdr.count;
+	if (!commit(slot, &e)) return SESSION_SLOT_NONE;
+	if (out) *out = e;
+	return slot;
+}
+
+bool SessionIndex::read(int32_t slot, SessionIndexEntry& out) const {
+	if (slot < 0 || (uint32_t)slot >= _hdr.count) return false;
+	fs::File f = FSYS.open(indexPath, "r");
+	if (!f) return false;
+	const bool ok = f.seek(entryPos(slot))
+	             && f.read((uint8_t*)&out, sizeof(out)) == sizeof(out);
+	f.close();
+	return ok && out.crc == sessionIndexEntryCrc(out);
+}
+
+uint32_t SessionIndex::readMany(int32_t first, SessionIndexEntry* out, uint32_t n) const {
+	if (first < 0 || (uint32_t)first >= _hdr.count) return 0;
+	if (n > _hdr.count - first) n = _hdr.count - first;
+	fs::File f = FSYS.open(indexPath, "r");
+	if (!f) return 0;
+	uint32_t got = 0;
+	if (f.seek(entryPos(first)))
+		got = f.read((uint8_t*)out, n * sizeof(SessionIndexEntry)) / sizeof(SessionIndexEntry);
+	f.close();
+	for (uint32_t i = 0; i < got; ++i)
+		if (out[i].crc != sessionIndexEntryCrc(out[i])) out[i].state = 0;
+	return got;
+}
+
+int32_t SessionIndex::lowerBound(uint32_t epoch) const {
+	fs::File f = FSYS.open(indexPath, "r");
+	if (!f) return 0;
+	uint32_t lo = 0, hi = _hdr.count;
+	while (lo < hi) {
+		const uint32_t mid = (lo + hi) / 2;
+		uint32_t e = 0;
+		f.seek(entryPos(mid) + offsetof(SessionIndexEntry, startEpoch));
+		if (f.read((uint8_t*)&e, sizeof(e)) != sizeof(e)) break;
+		if (e < epoch) lo = mid + 1;
+		else           hi = mid;
+	}
+	f.close();
+	return (int32_t)lo;
+}
+
+bool SessionIndex::write(int32_t slot, SessionIndexEntry& e) {
+	if (slot < 0 || (uint32_t)slot >= _hdr.count) return false;
+	return commit(slot, &e);
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+	y -= m <= 2;
+	const int32_t  era = (y >= 0 ? y : y - 399) / 400;
+	const uint32_t yoe = (uint32_t)(y - era * 400);
+	const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int32_t)doe - 719468;
+}
+
+uint32_t SessionIndex::idToEpoch(const char* id) {
+	unsigned Y = 0, M = 0, D = 0, h = 0, mi = 0, s = 0;
+	if (sscanf(id, "%4u%2u%2u_%2u%2u%2u", &Y, &M, &D, &h, &mi, &s) != 6) return 0;
+	if (M < 1 || M > 12 || D < 1 || D > 31) return 0;
+	return (uint32_t)daysFromCivil((int32_t)Y, M, D) * 86400u + h * 3600u + mi * 60u + s;
+}
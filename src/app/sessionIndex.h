@@ -0,0 +1,85 @@
+#pragma once
+#include <Arduino.h>
+
+/* Persistent session index
+ *
+ *   /sessions/index.hdr   SessionIndexHeader 32 B (count, open slot, seq)
+ *   /sessions/index.bin   SessionIndexEntry 64 B x count   (slot = creation order)
+ *
+ * - The header names the open session's slot, so resume is two small reads
+ * - The mutable header lives in its own file: LittleFS stores a file this small inline in
+ *   its metadata, so rewriting it costs no data blocks. index.bin is only written at the
+ *   slot being updated, which is the tail for the open session; LittleFS copies a file
+ *   from the first modified block onwards, so an update stays O(1) in the history length
+ * - An update writes the entry first, then the header; each file commits atomically at
+ *   close. An entry that landed without its header (crash in between) carries
+ *   seq == header seq + 1 and is rolled forward by begin(); a read-only begin() applies
+ *   the roll-forward to its copy of the header and leaves the files alone
+ * - Header and entries carry CRC-32s; a bad header means "rebuild from the directories"
+ */
+
+static const uint32_t SESSION_INDEX_MAGIC = 0x58444953;	// "SIDX"
+static const int32_t  SESSION_SLOT_NONE   = -1;
+
+enum : uint8_t { SESSION_STATE_OPEN = 1, SESSION_STATE_CLOSED = 2 };
+enum : uint8_t { SESSION_RESULT_NONE = 0, SESSION_RESULT_PASS = 1, SESSION_RESULT_FAIL = 2 };
+
+struct __attribute__((packed)) SessionIndexHeader {
+	uint32_t magic;
+	uint16_t version;		// 2 (1: header at the start of index.bin)
+	uint16_t entrySize;		// sizeof(SessionIndexEntry)
+	uint32_t count;			// entries in use
+	int32_t  openSlot;		// SESSION_SLOT_NONE if no session is open
+	uint32_t seq;			// bumped on every update
+	uint32_t reserved[2];
+	uint32_t crc;
+};
+
+struct __attribute__((packed)) SessionIndexEntry {
+	char     id[24];		// folder name under /sessions, NUL-terminated
+	uint32_t startEpoch;	// UTC seconds derived from the id
+	uint32_t counts[4];		// Api, Seconds, Rashi, Mangala
+	uint32_t last;			// last nut index
+	uint8_t  state;			// SESSION_STATE_*
+	uint8_t  result;		// SESSION_RESULT_*
+	uint16_t edits;			// override patches applied to nuts.bin in place (wraps)
+	uint32_t seq;			// header seq at the time of this write
+	uint32_t lastRecOffset;	// newest record in nuts.bin when this was written (0 = none)
+	uint32_t crc;
+};
+static_assert(sizeof(SessionIndexHeader) == 32, "index header layout");
+static_assert(sizeof(SessionIndexEntry) == 64, "index entry layout");
+
+class SessionIndex {
+public:
+	// Load the header. Returns false if the index is missing or corrupt (caller rebuilds).
+	// A read-only index (listings on the web task) never writes; its updates fail.
+	bool begin(bool readOnly = false);
+	// Start over with an empty index (used for rebuilds)
+	bool reset();
+
+	uint32_t count() const { return _hdr.count; }
+	int32_t  openSlot() const { return _hdr.openSlot; }
+
+	// Append a new session; returns its slot (and the stored entry) or SESSION_SLOT_NONE
+	int32_t add(const char* id, uint8_t state = SESSION_STATE_OPEN, SessionIndexEntry* out = nullptr);
+	bool read(int32_t slot, SessionIndexEntry& out) const;
+	// Up to 'n' consecutive entries from 'first' in one open; entries failing their CRC
+	// come back with state 0. Returns the number read.
+	uint32_t readMany(int32_t first, SessionIndexEntry* out, uint32_t n) const;
+	// First slot whose startEpoch >= epoch (ids are timestamps, so slots are in time order)
+	int32_t lowerBound(uint32_t epoch) const;
+	bool write(int32_t slot, SessionIndexEntry& e);	// stamps seq/crc, updates openSlot
+
+	static uint32_t idToEpoch(const char* id);	// "YYYYMMDD_hhmmss[-nn]" -> UTC seconds
+
+private:
+	bool commit(int32_t slot, SessionIndexEntry* e);
+	bool writeHeader(const SessionIndexHeader& h);
+	static void applyState(SessionIndexHeader& h, int32_t slot, const SessionIndexEntry& e);
+
+	SessionIndexHeader _hdr = {};
+	bool _readOnly = false;
+};
+
+uint32_t sessionIndexEntryCrc(const SessionIndexEntry& e);
@@ -0,0 +1,245 @@
+#include "sessionLog.h"
+#include "fs/fsCompat.h"
+#include "fs/crc32.h"
+#include "app/metrics.h"
+#include <assert.h>
+#include <stddef.h>
+
+static inline int16_t packSample(int32_t delta, uint8_t shift) {
+	return (int16_t)(delta >> shift);	// arithmetic shift keeps the sign
+}
+
+// CRC over the header as if overrideClass were unset and crc zero, then the payload
+static uint32_t headerCrc(const NutRecordHeader& hdr) {
+	NutRecordHeader h = hdr;
+	h.overrideClass = NUT_OVERRIDE_NONE;
+	h.crc = 0;
+	return crc32Update(0, &h, sizeof(h));
+}
+
+uint32_t nutRecordCrc(const NutRecordHeader& hdr, const int16_t* samples, uint16_t count) {
+	return crc32Update(headerCrc(hdr), samples, count * sizeof(int16_t));
+}
+
+/* -------------------- writer -------------------- */
+bool SessionLog::open(const String& path) {
+	close();
+	_path = path;
+	_fill = 0;
+	_flushed = 0;
+	_bytesWritten = 0;
+	_dropped = 0;
+	_failed = false;
+
+	if (FSYS.exists(path)) {
+		fs::File f = FSYS.open(path, "r");
+		if (f) { _flushed = f.size(); f.close(); }
+	}
+	if (_flushed == 0) {
+		NutLogFileHeader fh = {};
+		fh.magic = NUT_LOG_MAGIC;
+		fh.version = 1;
+		fh.recordHeaderSize = sizeof(NutRecordHeader);
+		memcpy(_buf, &fh, sizeof(fh));
+		_fill = sizeof(fh);
+	}
+	return true;
+}
+
+void SessionLog::close() {
+	if (!isOpen()) return;
+	sync();
+	_path = "";
+}
+
+bool SessionLog::writeOut() {
+	if (_failed) return false;
+	if (_fill == 0) return true;
+	const uint32_t t0 = micros();
+	fs::File f = FSYS.open(_path, "a");
+	if (!f) {
+		Serial.printf("[LOG] open failed: %s\n", _path.c_str());
+		_failed = true;
+		return false;
+	}
+	const size_t n = f.write(_buf, _fill);
+	f.close();
+	metricFsOpUs[METRIC_FS_LOG].observe(micros() - t0);
+	metricFlashBytes[METRIC_FS_LOG].inc(n);
+	if (n != _fill) {
+		Serial.printf("[LOG] short write %u/%u: %s\n", (unsigned)n, (unsigned)_fill, _path.c_str());
+		_failed = true;
+		return false;
+	}
+	_flushed += _fill;
+	_bytesWritten += _fill;
+	_fill = 0;
+	return true;
+}
+
+bool SessionLog::sync() {
+	return writeOut();
+}
+
+uint32_t SessionLog::append(NutRecordHeader& hdr, const int32_t* codes, uint16_t count) {
+	if (!isOpen()) return 0;
+	if (_failed) { _dropped++; return 0; }
+	const int32_t base = hdr.baseline;
+
+	int32_t maxAbs = 0;
+	for (uint16_t i = 0; i < count; ++i) {
+		const int32_t d = codes[i] - base;
+		const int32_t a = d < 0 ? -d : d;
+		if (a > maxAbs) maxAbs = a;
+	}
+	uint8_t shift = 0;
+	while ((maxAbs >> shift) > 32767) ++shift;
+
+	hdr.magic         = NUT_REC_MAGIC;
+	hdr.sampleCount   = count;
+	hdr.sampleShift   = shift;
+	hdr.overrideClass = NUT_OVERRIDE_NONE;
+	hdr.reserved      = 0;
+	hdr.crc           = 0;
+
+	// pass 1: CRC (the header has to be staged before the samples)
+	uint32_t crc = headerCrc(hdr);
+	for (uint16_t i = 0; i < count; ++i) {
+		const int16_t s = packSample(codes[i] - base, shift);
+		crc = crc32Update(crc, &s, sizeof(s));
+	}
+	hdr.crc = crc;
+
+	// pass 2: stage; chunks are cut at sector boundaries of the file
+	const uint32_t offset = size();
+	auto put = [&](const void* src, size_t len) -> bool {
+		const uint8_t* p = (const uint8_t*)src;
+		while (len) {
+			const uint32_t room = SESSION_LOG_CHUNK - ((_flushed + _fill) % SESSION_LOG_CHUNK);
+			const size_t n = len < room ? len : room;
+			assert(_fill + n <= SESSION_LOG_CHUNK);
+			memcpy(_buf + _fill, p, n);
+			_fill += n; p += n; len -= n;
+			if (n == room && !writeOut()) return false;
+		}
+		return true;
+	};
+
+	bool ok = put(&hdr, sizeof(hdr));
+	for (uint16_t i = 0; ok && i < count; ++i) {
+		const int16_t s = packSample(codes[i] - base, shift);
+		ok = put(&s, sizeof(s));
+	}
+	if (!ok) { _dropped++; return 0; }	// writeOut() failed: the log is now marked failed
+	return offset;
+}
+
+bool SessionLog::patchOverride(uint32_t recordOffset, uint8_t overrideClass) {
+	if (!isOpen()) return false;
+	const uint32_t pos = recordOffset + offsetof(NutRecordHeader, overrideClass);
+	if (pos >= size()) return false;
+
+	if (pos >= _flushed) {	// still staged in RAM
+		_buf[pos - _flushed] = overrideClass;
+		return true;
+	}
+	const uint32_t t0 = micros();
+	fs::File f = FSYS.open(_path, "r+");
+	if (!f) return false;
+	bool ok = f.seek(pos) && f.write(&overrideClass, 1) == 1;
+	f.close();
+	metricFsOpUs[METRIC_FS_LOG].observe(micros() - t0);
+	if (ok) {
+		// LittleFS copies the block holding 'pos' and every block after it when the file closes
+		const uint32_t rewritten = _flushed - pos / SESSION_LOG_CHUNK * SESSION_LOG_CHUNK;
+		_bytesWritten += rewritten;
+		metricFlashBytes[METRIC_FS_LOG].inc(rewritten);
+	}
+	return ok;
+}
+
+bool SessionLog::readHeader(uint32_t recordOffset, NutRecordHeader& hdr) {
+	if (!isOpen() || recordOffset < sizeof(NutLogFileHeader) || recordOffset + sizeof(hdr) > size()) return false;
+	uint8_t* out = (uint8_t*)&hdr;
+	uint32_t pos = recordOffset, n = sizeof(hdr);
+	if (pos < _flushed) {	// on flash, possibly running into the staged bytes
+		const uint32_t k = _flushed - pos < n ? _flushed - pos : n;
+		fs::File f = FSYS.open(_path, "r");
+		const bool ok = f && f.seek(pos) && f.read(out, k) == k;
+		if (f) f.close();
+		if (!ok) return false;
+		out += k; pos += k; n -= k;
+	}
+	if (n) memcpy(out, _buf + (pos - _flushed), n);
+	return hdr.magic == NUT_REC_MAGIC;
+}
+
+/* -------------------- reader -------------------- */
+bool SessionLogReader::open(const String& path) {
+	close();
+	_corrupt = false;
+	_f = FSYS.open(path, "r");
+	if (!_f) return false;
+	NutLogFileHeader fh;
+	if (_f.read((uint8_t*)&fh, sizeof(fh)) != sizeof(fh) || fh.magic != NUT_LOG_MAGIC
+	    || fh.recordHeaderSize != sizeof(NutRecordHeader)) {
+		_corrupt = true;
+		_f.close();
+		return false;
+	}
+	return true;
+}
+
+bool SessionLogReader::seek(uint32_t offset) {
+	return _f && offset >= sizeof(NutLogFileHeader) && offset < _f.size() && _f.seek(offset);
+}
+
+// Move to the next "NREC" after 'from' (used after a torn/corrupt record)
+static bool seekToMagic(fs::File& f, uint32_t from) {
+	uint8_t win[64];
+	uint32_t pos = from;
+	while (f.seek(pos)) {
+		const size_t n = f.read(win, sizeof(win));
+		if (n < 4) return false;
+		for (size_t i = 0; i + 4 <= n; ++i) {
+			uint32_t m; memcpy(&m, win + i, 4);
+			if (m == NUT_REC_MAGIC) return f.seek(pos + i);
+		}
+		pos += n - 3;
+	}
+	return false;
+}
+
+bool SessionLogReader::next(NutRecordHeader& hdr, int16_t* samples, uint16_t maxSamples, uint32_t* offsetOut) {
+	if (!_f) return false;
+	for (;;) {
+		const uint32_t pos = _f.position();
+		const size_t got = _f.read((uint8_t*)&hdr, sizeof(hdr));
+		if (got == 0) return false;					// clean end
+		if (got < sizeof(hdr)) { _corrupt = true; return false; }	// torn tail
+
+		bool ok = hdr.magic == NUT_REC_MAGIC
+		        && pos + sizeof(hdr) + hdr.sampleCount * sizeof(int16_t) <= _f.size();
+		if (ok) {
+			// stream the payload through the CRC; keep what fits in 'samples' (if any)
+			uint32_t crc = headerCrc(hdr);
+			int16_t  tmp[32];
+			for (uint16_t i = 0; ok && i < hdr.sampleCount; ) {
+				const uint16_t n = (hdr.sampleCount - i) < 32 ? (hdr.sampleCount - i) : 32;
+				ok = _f.read((uint8_t*)tmp, n * sizeof(int16_t)) == n * sizeof(int16_t);
+				if (!ok) break;
+				crc = crc32Update(crc, tmp, n * sizeof(int16_t));
+				if (samples) for (uint16_t k = 0; k < n && i + k < maxSamples; ++k) samples[i + k] = tmp[k];
+				i += n;
+			}
+			ok = ok && crc == hdr.crc;
+		}
+		if (ok) {
+			if (offsetOut) *offsetOut = pos;
+			return true;
+		}
+
+		_corrupt = true;
+		if (!seekToMagic(_f, pos + 1)) return false;
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+/* Append-only binary nut log: one file per session (<session>/nuts.bin)
+ *
+ *   [NutLogFileHeader 16 B] [NutRecordHeader 32 B][int16 samples x N] [NutRecordHeader]...
+ *
+ * - Samples are (adc_code - baseline) >> sampleShift, packed little-endian int16;
+ *   the shift is chosen per record so the peak fits without clipping
+ * - Each record carries a CRC-32 over its header and samples, computed with
+ *   overrideClass = 0xFF and crc = 0, so the override byte can be patched in place.
+ *   Patching a staged record is free; patching one already on flash makes LittleFS
+ *   rewrite the file from that record's block to the end, O(tail) rather than O(1)
+ * - Records are staged in RAM and written in chunks that end on SESSION_LOG_CHUNK
+ *   (flash sector) boundaries; sync() pushes out a partial chunk
+ * - A failed chunk write (open failure, short write, flash full) marks the log failed:
+ *   the file may end in a torn record and later offsets would no longer match, so
+ *   further appends are refused (and counted) until the log is reopened
+ */
+
+#ifndef SESSION_LOG_CHUNK
+#define SESSION_LOG_CHUNK	4096	// LittleFS block size on ESP32
+#endif
+
+static const uint32_t NUT_LOG_MAGIC = 0x4C54554E;	// "NUTL"
+static const uint32_t NUT_REC_MAGIC = 0x4345524E;	// "NREC"
+static const uint8_t  NUT_OVERRIDE_NONE = 0xFF;
+
+enum : uint8_t {
+	NUT_REC_TRUNCATED = 0x01,	// segmenter hit its window limit
+	NUT_REC_SIMULATED = 0x02,	// synthetic trace from /api/simulate
+};
+
+struct __attribute__((packed)) NutLogFileHeader {
+	uint32_t magic;			// NUT_LOG_MAGIC
+	uint16_t version;		// 1
+	uint16_t recordHeaderSize;	// sizeof(NutRecordHeader)
+	uint32_t reserved[2];
+};
+
+struct __attribute__((packed)) NutRecordHeader {
+	uint32_t magic;			// NUT_REC_MAGIC
+	uint32_t index;			// nut number within the session (1-based)
+	uint32_t tStartUs;		// timestamp of sample 0
+	int32_t  baseline;		// ADC codes
+	uint16_t sampleCount;
+	uint16_t periodUs;		// sample spacing
+	uint16_t triggerIdx;
+	uint8_t  predClass;		// NutClass from the classifier (or the simulate request)
+	uint8_t  confidence;	// 0..255
+	uint8_t  flags;			// NUT_REC_*
+	uint8_t  overrideClass;	// NUT_OVERRIDE_NONE or the operator's pick; excluded from the CRC
+	uint8_t  sampleShift;	// stored sample = (code - baseline) >> sampleShift
+	uint8_t  reserved;
+	uint32_t crc;
+};
+static_assert(sizeof(NutLogFileHeader) == 16, "file header layout");
+static_assert(sizeof(NutRecordHeader) == 32, "record header layout");
+
+class SessionLog {
+public:
+	// Create (or reopen for append) the log at 'path'
+	bool open(const String& path);
+	void close();				// sync + forget the path
+	bool isOpen() const { return _path.length() > 0; }
+
+	// Stage one record; fills magic/sampleCount/sampleShift/crc in 'hdr'. 'codes' are raw
+	// ADC codes (hdr.baseline is subtracted). Returns the record's file offset, 0 on failure.
+	uint32_t append(NutRecordHeader& hdr, const int32_t* codes, uint16_t count);
+
+	// Rewrite the override byte of the record at 'recordOffset' (RAM if still staged;
+	// on flash this costs a rewrite of the file's tail, counted in bytesWritten())
+	bool patchOverride(uint32_t recordOffset, uint8_t overrideClass);
+	// Header of the record at 'recordOffset' (RAM if still staged); false if there is none
+	bool readHeader(uint32_t recordOffset, NutRecordHeader& hdr);
+
+	bool sync();				// write any staged bytes now
+
+	uint32_t size() const { return _flushed + _fill; }
+	uint32_t staged() const { return _fill; }
+	uint32_t bytesWritten() const { return _bytesWritten; }	// to flash, this session
+	bool     failed() const { return _failed; }
+	uint32_t droppedRecords() const { return _dropped; }		// appends refused since open()
+
+private:
+	bool writeOut();
+
+	String   _path;
+	uint32_t _flushed = 0;		// bytes already on flash
+	uint32_t _fill = 0;			// bytes staged in _buf
+	uint32_t _bytesWritten = 0;
+	uint32_t _dropped = 0;
+	bool     _failed = false;
+	uint8_t  _buf[SESSION_LOG_CHUNK];
+};
+
+// Sequential reader; every record is CRC-checked, with or without its payload. A torn or
+// corrupt record is skipped by resyncing at the next record magic, and corrupt() reports
+// that something was skipped; a torn tail ends the log.
+class SessionLogReader {
+public:
+	bool open(const String& path);
+	void close() { if (_f) _f.close(); }
+
+	// Reads the next valid record. 'samples' may be null to skip the payload (it is still
+	// read for the CRC). Returns false at the end of the log.
+	bool next(NutRecordHeader& hdr, int16_t* samples, uint16_t maxSamples, uint32_t* offsetOut = nullptr);
+	// Continue from a known record offset (e.g. one returned by next() earlier)
+	bool seek(uint32_t offset);
+	bool corrupt() const { return _corrupt; }
+
+private:
+	fs::File _f;
+	bool _corrupt = false;
+};
+
+uint32_t nutRecordCrc(const NutRecordHeader& hdr, const int16_t* samples, uint16_t count);
@@ -1,18 +1,32 @@
 #include "sessionManager.h"
 #include "fs/fsCompat.h"
+#include "fs/atomicFile.h"
+#include "fs/jsonWriter.h"
+#include "app/metrics.h"
+#include "dsp/nutSegmenter.h"
 #include <FS.h>
 #include <time.h>
+#include <sys/time.h>
+#include <vector>
+#include <algorithm>
 
 static const char* sessionsDir = "/sessions";
 
+static const time_t CLOCK_VALID_EPOCH = 1577836800;	// 2020-01-01: anything earlier is "never set"
+static const time_t FALLBACK_EPOCH    = 1762516800;	// 2025-11-07 12:00:00, first sequence stamp
+
 static String two(uint32_t v)  { char b[3];  snprintf(b, sizeof(b), "%02u", (unsigned)v); return String(b); }
 static String four(uint32_t v) { char b[5];  snprintf(b, sizeof(b), "%04u", (unsigned)v); return String(b); }
 
 void SessionManager::begin() {
 	if (!FSYS.exists(sessionsDir)) FSYS.mkdir(sessionsDir);
+	if (!_index.begin()) rebuildIndex();
 }
 
 bool SessionManager::startSession() {
+	if (_open) flush();	// commit whatever the previous session still holds in RAM
+	_log.close();
+
 	_counts = ClassCounts{};
 	_lastIndex = 0;
 	_open = false;
@@ -25,15 +39,22 @@ bool SessionManager::startSession() {
 	}
 
 	time_t now = time(nullptr);
+	if (now < CLOCK_VALID_EPOCH) {
+		// No wall time: one second after the newest session keeps ids unique and in slot
+		// order, so the -nn suffixes below cap starts per second, not the whole history
+		SessionIndexEntry last;
+		const uint32_t n = _index.count();
+		now = FALLBACK_EPOCH;
+		if (n && _index.read((int32_t)n - 1, last) && (time_t)last.startEpoch >= FALLBACK_EPOCH)
+			now = (time_t)last.startEpoch + 1;
+	}
 	struct tm t; gmtime_r(&now, &t);
-	// fallback if time not set
-	if (t.tm_year < 120) { t.tm_year = 125; t.tm_mon = 10; t.tm_mday = 7; t.tm_hour = 12; t.tm_min = 0; t.tm_sec = 0; }
 
 	String base = String(sessionsDir) + "/"
 		+ four(t.tm_year + 1900) + two(t.tm_mon + 1) + two(t.tm_mday)
 		+ "_" + two(t.tm_hour) + two(t.tm_min) + two(t.tm_sec);
 
-	// ensure uniqueness if same timestamp
+	// ensure uniqueness if same timestamp (at most 100 starts share one second)
 	String path = base;
 	for (int n = 1; FSYS.exists(path) && n <= 99; ++n) {
 		char suf[5]; snprintf(suf, sizeof(suf), "-%02d", n);
@@ -49,19 +70,64 @@ bool SessionManager::startSession() {
 	}
 
 	_sessionPath = path;
+	_slot = _index.add(path.substring(strlen(sessionsDir) + 1).c_str(), SESSION_STATE_OPEN, &_entry);
+	if (_slot == SESSION_SLOT_NONE) Serial.println("[SESSION] index add failed");
+	_log.open(path + "/nuts.bin");
+	_lastRecOffset = 0;
+	clearCorrections();
+	_dirty = false;
+	_pendingBytes = 0;
+	_flashBytes = 0;
+	_sessionTag++;
 	_open = true;
 	return writeSessionJson();
 }
 
+bool SessionManager::clockSet() {
+	return time(nullptr) >= CLOCK_VALID_EPOCH;
+}
+
+bool SessionManager::setClock(uint32_t epoch) {
+	if (clockSet()) return true;
+	if ((time_t)epoch < CLOCK_VALID_EPOCH) return false;
+	const struct timeval tv = { (time_t)epoch, 0 };
+	if (settimeofday(&tv, nullptr) != 0) return false;
+	Serial.printf("[SESSION] clock set from client: %u\n", (unsigned)epoch);
+	return true;
+}
+
 bool SessionManager::endSession() {
+	const bool ok = _open ? flush() : true;
+	_log.close();
+	if (_open && _slot != SESSION_SLOT_NONE) {
+		_entry.state = SESSION_STATE_CLOSED;
+		_index.write(_slot, _entry);
+	}
 	_open = false;
-	return true;
+	clearCorrections();
+	return ok;
 }
 
 bool SessionManager::addSimulatedNut(NutClass cls) {
+	return recordNut(cls, 255, nullptr, NUT_REC_SIMULATED);
+}
+
+bool SessionManager::addNut(NutClass cls, const NutWindow& w, uint8_t confidence) {
+	return recordNut(cls, confidence, &w, 0);
+}
+
+bool SessionManager::addReplayedNut(NutClass cls, const NutWindow& w) {
+	return recordNut(cls, 255, &w, NUT_REC_SIMULATED);
+}
+
+bool SessionManager::recordNut(NutClass cls, uint8_t confidence, const NutWindow* w, uint8_t flags) {
 	if (!_open) {
 		if (!startSession()) return false;
 	}
+	// Log first: a nut the log refused is not counted, so counts, index entry and
+	// session.json never run ahead of nuts.bin (and _lastIndex stays paired with _lastRecOffset)
+	const uint32_t before = _log.size();
+	if (!appendNutRecord(_lastIndex + 1, cls, confidence, w, flags)) return false;
 	_lastIndex++;
 	switch (cls) {
 		case NutClass::Api:		_counts.api++;		break;
@@ -70,49 +136,69 @@ bool SessionManager::addSimulatedNut(NutClass cls) {
 		case NutClass::Mangala:	_counts.mangala++;	break;
 		default: /* Unknown */	break;
 	}
-	if (!writeCsvForNut(_lastIndex, cls)) return false;
-	return writeSessionJson();
+	metricNuts[(uint8_t)cls < 4 ? (uint8_t)cls : 4].inc();
+	markDirty(_log.size() - before);
+	return true;
 }
 
-bool SessionManager::writeCsvForNut(uint32_t idx, NutClass cls) {
+bool SessionManager::appendNutRecord(uint32_t idx, NutClass cls, uint8_t confidence, const NutWindow* w, uint8_t flags) {
 	if (!_open) return false;
 
-	char fileName[32];
-	snprintf(fileName, sizeof(fileName), "/nut%05u.csv", (unsigned)idx);
-	String path = _sessionPath + String(fileName);
-
-	fs::File f = FSYS.open(path, "w");
-	if (!f) {
-		Serial.printf("[SESSION] open file failed: %s\n", path.c_str());
-		return false;
+	NutRecordHeader h = {};
+	h.index      = idx;
+	h.predClass  = (uint8_t)cls;
+	h.confidence = confidence;
+	h.flags      = flags;
+
+	uint32_t off = 0;
+	if (w) {
+		h.tStartUs   = w->tStartUs;
+		h.baseline   = w->baseline;
+		h.periodUs   = (uint16_t)w->periodUs();
+		h.triggerIdx = w->triggerIdx;
+		if (w->truncated) h.flags |= NUT_REC_TRUNCATED;
+		off = _log.append(h, w->samples, w->count);
+	} else {
+		// Minimal synthetic trace for /api/simulate
+		int32_t codes[21];
+		for (int i = 0; i <= 20; ++i) codes[i] = 100 + (i <= 10 ? i * 5 : (20 - i) * 5);
+		h.tStartUs   = micros();
+		h.baseline   = 100;
+		h.periodUs   = 10000;
+		h.triggerIdx = 0;
+		off = _log.append(h, codes, 21);
 	}
-
-	// Minimal synthetic trace so you can download something real
-	f.println("t_ms,adc_code,baseline,pred_class,override_class");
-	for (int i = 0; i <= 20; ++i) {
-		int code = 100 + (i <= 10 ? i * 5 : (20 - i) * 5);
-		f.printf("%d,%d,%d,%s,\n", i * 10, code, 100, className(cls));
+	if (!off) {
+		Serial.printf("[SESSION] log append failed in %s\n", _sessionPath.c_str());
+		return false;
 	}
-	f.close();
+	_lastRecOffset = off;
+	_lastPred      = cls;
+	_lastOverride  = NUT_OVERRIDE_NONE;
 	return true;
 }
 
 bool SessionManager::writeSessionJson() {
 	if (!_open) return false;
-	fs::File f = FSYS.open(_sessionPath + "/session.json", "w");
-	if (!f) {
-		Serial.printf("[SESSION] open session.json failed in %s\n", _sessionPath.c_str());
+	char buf[256];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject()
+	  .field("path", _sessionPath.c_str())
+	  .field("last", _lastIndex)
+	  .beginObject("counts")
+	  .field("Api", _counts.api).field("Seconds", _counts.seconds)
+	  .field("Rashi", _counts.rashi).field("Mangala", _counts.mangala)
+	  .endObject()
+	  .endObject();
+	if (out.overflow()) return false;
+
+	const size_t n = out.length();
+	if (!atomicWriteFile(_sessionPath + "/session.json", buf, n)) {
+		Serial.printf("[SESSION] session.json write failed in %s\n", _sessionPath.c_str());
 		return false;
 	}
-
-	f.print("{\"path\":\"");		f.print(_sessionPath);		f.print("\",");
-	f.print("\"last\":");			f.print(_lastIndex);		f.print(",");
-	f.print("\"counts\":{");
-	f.print("\"Api\":");			f.print(_counts.api);		f.print(",");
-	f.print("\"Seconds\":");		f.print(_counts.seconds);	f.print(",");
-	f.print("\"Rashi\":");			f.print(_counts.rashi);		f.print(",");
-	f.print("\"Mangala\":");		f.print(_counts.mangala);	f.print("}}");
-	f.close();
+	_flashBytes += ATOMIC_HEADER_LEN + n;
 	return true;
 }
 
@@ -145,25 +231,31 @@ const char* SessionManager::className(NutClass c) {
 
 bool SessionManager::writeResult(bool passed, float api, float seconds, float rashi, float mangala) {
 	if (_sessionPath.isEmpty()) return false;
-	fs::File f = FSYS.open(_sessionPath + "/result.json", "w");
-	if (!f) return false;
-	f.print("{\"passed\":"); f.print(passed ? "true" : "false");
-	f.print(",\"percents\":{");
-	f.print("\"Api\":"); f.print(api, 1); f.print(",");
-	f.print("\"Seconds\":"); f.print(seconds, 1); f.print(",");
-	f.print("\"Rashi\":"); f.print(rashi, 1); f.print(",");
-	f.print("\"Mangala\":"); f.print(mangala, 1); f.print("}}");
-	f.close();
+	char buf[128];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject()
+	  .field("passed", passed)
+	  .beginObject("percents")
+	  .field1("Api", api).field1("Seconds", seconds).field1("Rashi", rashi).field1("Mangala", mangala)
+	  .endObject()
+	  .endObject();
+	if (out.overflow()) return false;
+	if (!atomicWriteFile(_sessionPath + "/result.json", buf, out.length())) return false;
+
+	if (_slot != SESSION_SLOT_NONE) {
+		_entry.state  = SESSION_STATE_CLOSED;
+		_entry.result = passed ? SESSION_RESULT_PASS : SESSION_RESULT_FAIL;
+		_index.write(_slot, _entry);
+	}
 	return true;
 }
 
 // ---- helpers for JSON reading (tiny & tolerant) ----
 static bool sm_readSessionJsonAtPath(const String& dirPath, ClassCounts& counts, uint32_t& lastIdx) {
-	fs::File f = FSYS.open(dirPath + "/session.json", "r");
-	if (!f) return false;
-	String js; js.reserve(512);
-	while (f.available()) js += (char)f.read();
-	f.close();
+	char buf[512];
+	if (atomicReadFile(dirPath + "/session.json", buf, sizeof(buf)) < 0) return false;
+	const String js(buf);
 
 	auto grabNum = [&](const char* key, const char* parent) -> uint32_t {
 		if (parent) {
@@ -188,124 +280,242 @@ static bool sm_readSessionJsonAtPath(const String& dirPath, ClassCounts& counts,
 }
 
 bool SessionManager::resumeIfOpen() {
-	// find newest /sessions/<folder> that has *no* result.json
-	if (!FSYS.exists("/sessions")) return false;
-	fs::File root = FSYS.open("/sessions");
-	if (!root || !root.isDirectory()) return false;
-
-	String best;
-	for (fs::File e = root.openNextFile(); e; e = root.openNextFile()) {
-		if (!e.isDirectory()) continue;
-		String dir = String(e.path());
-		if (!dir.startsWith("/")) dir = "/" + dir;
-		if (FSYS.exists(dir + "/result.json")) continue; // treated as closed
-		if (best.isEmpty() || dir > best) best = dir;    // lexicographically newest
+	// The index header names the open session: one file open, no directory walk
+	const int32_t slot = _index.openSlot();
+	if (slot == SESSION_SLOT_NONE) return false;
+	SessionIndexEntry e;
+	if (!_index.read(slot, e) || e.state != SESSION_STATE_OPEN) {
+		Serial.println("[SESSION] index entry unreadable; rebuilding");
+		rebuildIndex();
+		if (_index.openSlot() == SESSION_SLOT_NONE || !_index.read(_index.openSlot(), e)) return false;
 	}
-	if (best.isEmpty()) return false;
 
-	ClassCounts c; uint32_t last = 0;
-	if (!sm_readSessionJsonAtPath(best, c, last)) return false;
-
-	_sessionPath = best;
-	_counts = c;
-	_lastIndex = last;
+	_slot  = _index.openSlot();
+	_entry = e;
+	_sessionPath = String(sessionsDir) + "/" + e.id;
+	_counts.api     = e.counts[0];
+	_counts.seconds = e.counts[1];
+	_counts.rashi   = e.counts[2];
+	_counts.mangala = e.counts[3];
+	_lastIndex = e.last;
+	_log.open(_sessionPath + "/nuts.bin");
+	_dirty = false;
+	_pendingBytes = 0;
+	loadLastRecord(e.lastRecOffset);
+	clearCorrections();	// history is RAM-only; it does not survive a reboot
+	_sessionTag++;
 	_open = true;
 
 	Serial.printf("[SESSION] resumeIfOpen -> %s (last=%u)\n", _sessionPath.c_str(), (unsigned)_lastIndex);
 	return true;
 }
 
-// tiny CSV splitter
-static int splitCsv(const String& s, char delim, String out[], int maxParts) {
-	int count = 0, start = 0;
-	for (int i = 0; i < (int)s.length() && count < maxParts - 1; ++i) {
-		if (s[i] == delim) { out[count++] = s.substring(start, i); start = i + 1; }
+// One-time migration / repair: walk /sessions and recreate index.bin in folder-name order
+void SessionManager::rebuildIndex() {
+	std::vector<String> dirs;
+	fs::File root = FSYS.open(sessionsDir);
+	if (root && root.isDirectory()) {
+		for (fs::File e = root.openNextFile(); e; e = root.openNextFile()) {
+			if (!e.isDirectory()) continue;
+			String dir = String(e.path());
+			if (!dir.startsWith("/")) dir = "/" + dir;
+			dirs.push_back(dir);
+		}
+	}
+	std::sort(dirs.begin(), dirs.end());	// names are timestamps: lexicographic == chronological
+
+	if (!_index.reset()) { Serial.println("[SESSION] index reset failed"); return; }
+	for (const String& dir : dirs) {
+		char result[128];
+		const bool closed = atomicReadFile(dir + "/result.json", result, sizeof(result)) >= 0;
+		SessionIndexEntry e;
+		const int32_t slot = _index.add(dir.substring(strlen(sessionsDir) + 1).c_str(),
+			closed ? SESSION_STATE_CLOSED : SESSION_STATE_OPEN, &e);
+		if (slot == SESSION_SLOT_NONE) continue;
+
+		ClassCounts c; uint32_t last = 0;
+		if (sm_readSessionJsonAtPath(dir, c, last)) {
+			e.counts[0] = c.api; e.counts[1] = c.seconds; e.counts[2] = c.rashi; e.counts[3] = c.mangala;
+			e.last = last;
+		}
+		if (closed) e.result = strstr(result, "\"passed\":true") ? SESSION_RESULT_PASS : SESSION_RESULT_FAIL;
+		_index.write(slot, e);
 	}
-	out[count++] = s.substring(start);
-	return count;
+	Serial.printf("[SESSION] index rebuilt: %u sessions\n", (unsigned)_index.count());
 }
 
-bool SessionManager::reclassifyLast(NutClass newClass, NutClass* oldClassOut) {
-	if (!_open || _lastIndex == 0) return false;
-	if (newClass == NutClass::Unknown) return false;
-
-	char fileName[32];
-	snprintf(fileName, sizeof(fileName), "/nut%05u.csv", (unsigned)_lastIndex);
-	String path = _sessionPath + String(fileName);
-
-	fs::File f = FSYS.open(path, "r");
-	if (!f) return false;
-	String content; content.reserve(2048);
-	while (f.available()) content += (char)f.read();
-	f.close();
-
-	int lastLineStart = content.lastIndexOf('\n', content.length() - 2);
-	if (lastLineStart < 0) return false;
-	String lastLine = content.substring(lastLineStart + 1);
-	lastLine.trim();
-	if (lastLine.length() == 0) {
-		int prev = content.lastIndexOf('\n', lastLineStart - 1);
-		if (prev < 0) return false;
-		lastLine = content.substring(prev + 1, lastLineStart);
-		lastLine.trim();
+static void bumpCount(ClassCounts& c, NutClass cls, int delta) {
+	uint32_t* n = nullptr;
+	switch (cls) {
+		case NutClass::Api:		n = &c.api; break;
+		case NutClass::Seconds:	n = &c.seconds; break;
+		case NutClass::Rashi:	n = &c.rashi; break;
+		case NutClass::Mangala:	n = &c.mangala; break;
+		default: return;	// Unknown is not counted
 	}
+	if (delta < 0 && *n == 0) return;
+	*n += delta;
+}
 
-	// t_ms,adc_code,baseline,pred_class,override_class
-	String cols[6];
-	int n = splitCsv(lastLine, ',', cols, 6);
-	if (n < 4) return false;
-	NutClass pred = parseClass(cols[3]);
-	NutClass prevEff = pred;
-	if (n >= 5 && cols[4].length() > 0) prevEff = parseClass(cols[4]);
+static inline NutClass effectiveClass(NutClass pred, uint8_t ov) {
+	return ov != NUT_OVERRIDE_NONE ? (NutClass)ov : pred;
+}
 
-	if (oldClassOut) *oldClassOut = prevEff;
-	if (prevEff == newClass) return true;
-
-	switch (prevEff) {
-		case NutClass::Api:		if (_counts.api) _counts.api--; break;
-		case NutClass::Seconds:	if (_counts.seconds) _counts.seconds--; break;
-		case NutClass::Rashi:	if (_counts.rashi) _counts.rashi--; break;
-		case NutClass::Mangala:	if (_counts.mangala) _counts.mangala--; break;
-		default: break;
+// Recover the last record's offset/classes so reclassifyLast() works after a resume. The
+// index entry names the newest record it had seen, so only the records behind it are read
+// (a full scan if it names none); records that reached nuts.bin after that index write
+// are counted in here.
+void SessionManager::loadLastRecord(uint32_t fromOffset) {
+	_lastRecOffset = 0;
+	_lastPred = NutClass::Unknown;
+	_lastOverride = NUT_OVERRIDE_NONE;
+
+	SessionLogReader rd;
+	if (!rd.open(_sessionPath + "/nuts.bin")) return;
+	if (fromOffset && !rd.seek(fromOffset)) {
+		Serial.printf("[SESSION] index names record @%u past the log; scanning\n", (unsigned)fromOffset);
+	}
+	NutRecordHeader h; uint32_t off = 0, caught = 0;
+	while (rd.next(h, nullptr, 0, &off)) {
+		_lastRecOffset = off;
+		_lastPred      = (NutClass)h.predClass;
+		_lastOverride  = h.overrideClass;
+		if (h.index > _lastIndex) {
+			_lastIndex = h.index;
+			bumpCount(_counts, effectiveClass(_lastPred, _lastOverride), +1);
+			++caught;
+		}
 	}
-	switch (newClass) {
-		case NutClass::Api:		_counts.api++; break;
-		case NutClass::Seconds:	_counts.seconds++; break;
-		case NutClass::Rashi:	_counts.rashi++; break;
-		case NutClass::Mangala:	_counts.mangala++; break;
-		default: break;
+	rd.close();
+	if (caught) {
+		Serial.printf("[SESSION] %u record(s) newer than the index\n", (unsigned)caught);
+		markDirty(0);
 	}
+}
 
-	// rewrite CSV with override_class=newClass on every data row
-	String rebuilt; rebuilt.reserve(content.length() + 32);
-	int pos = 0; int lineNo = 0;
-	while (pos < (int)content.length()) {
-		int end = content.indexOf('\n', pos);
-		if (end < 0) end = content.length();
-		String line = content.substring(pos, end);
+// One-byte patch of a record's override plus the matching count move. Free while the record
+// is staged; once it is on flash the patch rewrites nuts.bin from its block on (O(tail)), so
+// corrections to recent nuts stay cheap and ones deep in a long session are not
+bool SessionManager::applyOverride(uint32_t recOffset, NutClass pred, uint8_t fromOv, uint8_t toOv) {
+	if (!_log.patchOverride(recOffset, toOv)) return false;
+	bumpCount(_counts, effectiveClass(pred, fromOv), -1);
+	bumpCount(_counts, effectiveClass(pred, toOv), +1);
+	if (recOffset == _lastRecOffset) _lastOverride = toOv;
+	_entry.edits++;		// persisted with the counts by the next flush
+	markDirty(1);
+	return true;
+}
 
-		if (lineNo == 0) {
-			rebuilt += line; rebuilt += '\n';
-		} else {
-			String c[6];
-			int cc = splitCsv(line, ',', c, 6);
-			if (cc >= 4) {
-				rebuilt += c[0]; rebuilt += ',';
-				rebuilt += c[1]; rebuilt += ',';
-				rebuilt += c[2]; rebuilt += ',';
-				rebuilt += c[3]; rebuilt += ',';
-				rebuilt += className(newClass); rebuilt += '\n';
-			} else {
-				rebuilt += line; rebuilt += '\n';
-			}
-		}
-		pos = end + 1; lineNo++;
-	}
+uint16_t SessionManager::logEdits(const char* id) {
+	if (_open && _slot != SESSION_SLOT_NONE && strcmp(_entry.id, id) == 0) return _entry.edits;
+	// ids are timestamps ("-nn" for same-second starts): scan the slots sharing this one's second
+	const uint32_t epoch = SessionIndex::idToEpoch(id);
+	SessionIndexEntry e;
+	for (int32_t slot = _index.lowerBound(epoch); _index.read(slot, e) && e.startEpoch == epoch; ++slot)
+		if (strcmp(e.id, id) == 0) return e.edits;
+	return 0;
+}
 
-	fs::File w = FSYS.open(path, "w");
-	if (!w) return false;
-	w.print(rebuilt);
-	w.close();
+// A new correction: patch + counts, then onto the undo ring (dropping anything that
+// could have been redone)
+bool SessionManager::applyCorrection(const NutCorrection& c, NutClass* oldClassOut) {
+	const NutClass prevEff = effectiveClass((NutClass)c.pred, c.fromOv);
+	if (oldClassOut) *oldClassOut = prevEff;
+	if (prevEff == (NutClass)c.toOv) return true;
+	if (!applyOverride(c.recOffset, (NutClass)c.pred, c.fromOv, c.toOv)) return false;
 
-	return writeSessionJson();
+	_hist[(_histBase + _histUndo) % SESSION_UNDO_DEPTH] = c;
+	if (_histUndo == SESSION_UNDO_DEPTH) _histBase = (_histBase + 1) % SESSION_UNDO_DEPTH;
+	else _histUndo++;
+	_histRedo = 0;
+	return true;
+}
+
+bool SessionManager::reclassifyLast(NutClass newClass, NutClass* oldClassOut) {
+	if (!_open || _lastIndex == 0 || _lastRecOffset == 0) return false;
+	if (newClass == NutClass::Unknown) return false;
+
+	NutCorrection c;
+	c.recOffset = _lastRecOffset;
+	c.index     = _lastIndex;
+	c.pred      = (uint8_t)_lastPred;
+	c.fromOv    = _lastOverride;
+	c.toOv      = (uint8_t)newClass;
+	return applyCorrection(c, oldClassOut);
+}
+
+bool SessionManager::reclassifyAt(const NutRef& ref, NutClass newClass, NutClass* oldClassOut, uint32_t* indexOut) {
+	if (!_open || ref.recOffset == 0 || ref.session != _sessionTag) return false;
+	if (newClass == NutClass::Unknown) return false;
+
+	NutRecordHeader h;
+	if (!_log.readHeader(ref.recOffset, h)) return false;
+	if (indexOut) *indexOut = h.index;
+
+	NutCorrection c;
+	c.recOffset = ref.recOffset;
+	c.index     = h.index;
+	c.pred      = h.predClass;
+	c.fromOv    = h.overrideClass;
+	c.toOv      = (uint8_t)newClass;
+	return applyCorrection(c, oldClassOut);
+}
+
+bool SessionManager::undoCorrection(NutCorrection* out) {
+	if (!_open || _histUndo == 0) return false;
+	const NutCorrection& c = _hist[(_histBase + _histUndo - 1) % SESSION_UNDO_DEPTH];
+	if (!applyOverride(c.recOffset, (NutClass)c.pred, c.toOv, c.fromOv)) return false;
+	_histUndo--;
+	_histRedo++;
+	if (out) *out = c;
+	return true;
+}
+
+bool SessionManager::redoCorrection(NutCorrection* out) {
+	if (!_open || _histRedo == 0) return false;
+	const NutCorrection& c = _hist[(_histBase + _histUndo) % SESSION_UNDO_DEPTH];
+	if (!applyOverride(c.recOffset, (NutClass)c.pred, c.fromOv, c.toOv)) return false;
+	_histUndo++;
+	_histRedo--;
+	if (out) *out = c;
+	return true;
+}
+
+void SessionManager::clearCorrections() {
+	_histBase = _histUndo = _histRedo = 0;
+}
+
+/* -------------------- group commit -------------------- */
+void SessionManager::markDirty(uint32_t bytes) {
+	if (!_dirty) { _dirty = true; _dirtySinceMs = millis(); }
+	_pendingBytes += bytes;
+}
+
+uint32_t SessionManager::pendingMs() const {
+	return _dirty ? millis() - _dirtySinceMs : 0;
+}
+
+bool SessionManager::flush() {
+	if (!_dirty) return true;
+	bool ok = _log.sync();
+	ok = writeSessionJson() && ok;
+	ok = syncIndexEntry() && ok;
+	if (ok) { _dirty = false; _pendingBytes = 0; }
+	return ok;
+}
+
+bool SessionManager::syncIndexEntry() {
+	if (_slot == SESSION_SLOT_NONE) return true;
+	_entry.counts[0] = _counts.api;
+	_entry.counts[1] = _counts.seconds;
+	_entry.counts[2] = _counts.rashi;
+	_entry.counts[3] = _counts.mangala;
+	_entry.last      = _lastIndex;
+	_entry.lastRecOffset = _lastRecOffset;
+	return _index.write(_slot, _entry);
+}
+
+void SessionManager::poll() {
+	if (!_open || !_dirty) return;
+	if (_pendingBytes >= SESSION_FLUSH_BYTES || millis() - _dirtySinceMs >= SESSION_FLUSH_MS) flush();
 }
@@ -1,13 +1,40 @@
 #pragma once
 #include <Arduino.h>
+#include "app/nutClass.h"
+#include "app/sessionLog.h"
+#include "app/sessionIndex.h"
 
-enum class NutClass : uint8_t { Api=0, Seconds=1, Rashi=2, Mangala=3, Unknown=255 };
+struct NutWindow;
+
+// Group commit: nut records and session.json are held in RAM and written together once
+// SESSION_FLUSH_BYTES of records are pending, SESSION_FLUSH_MS after the first unsaved
+// change, or at session end. A power loss can cost at most SESSION_FLUSH_MS of nuts
+// (plus one poll() interval).
+#ifndef SESSION_FLUSH_MS
+#define SESSION_FLUSH_MS	2000
+#endif
+#ifndef SESSION_FLUSH_BYTES
+#define SESSION_FLUSH_BYTES	4096
+#endif
+
+// Operator corrections kept for undo/redo (RAM only, current session)
+#ifndef SESSION_UNDO_DEPTH
+#define SESSION_UNDO_DEPTH	16
+#endif
 
 struct ClassCounts {
 	uint32_t api = 0, seconds = 0, rashi = 0, mangala = 0;
 	uint32_t total() const { return api + seconds + rashi + mangala; }
 };
 
+struct NutCorrection {
+	uint32_t recOffset;		// record offset in nuts.bin
+	uint32_t index;			// nut number
+	uint8_t  pred;			// classifier's NutClass
+	uint8_t  fromOv;		// override byte before / after the correction
+	uint8_t  toOv;
+};
+
 class SessionManager {
 public:
 	void begin();
@@ -17,12 +44,36 @@ public:
 	String currentPath() const { return _sessionPath; }
 
 	bool addSimulatedNut(NutClass cls);
+	// Record a segmented nut from the ADC pipeline; the session log carries the real trace
+	bool addNut(NutClass cls, const NutWindow& w, uint8_t confidence = 0);
+	// Stored trace fed back through the session (bulk replay); flagged as simulated
+	bool addReplayedNut(NutClass cls, const NutWindow& w);
 	ClassCounts getCounts() const { return _counts; }
+	uint32_t lastIndex() const { return _lastIndex; }	// number of the newest nut
 	void getPercentages(float &api, float &seconds, float &rashi, float &mangala) const;
 
 	static NutClass parseClass(const String &s);
 	static const char* className(NutClass c);
 
+	// Session ids are UTC start times, and the device has no NTP: a client supplies the
+	// time (POST /api/session/start?t=). Only the first one is taken, so a client with a
+	// skewed clock cannot move later ids before earlier ones. Until then ids are sequence
+	// stamps: one second after the newest indexed session.
+	static bool setClock(uint32_t epoch);
+	static bool clockSet();
+
+	// Write-back persistence: call often from the owning thread; flush() forces a commit
+	void poll();
+	bool flush();
+	uint32_t pendingBytes() const { return _pendingBytes; }
+	uint32_t pendingMs() const;				// age of the oldest unsaved change (0 = clean)
+	static uint32_t maxLossMs() { return SESSION_FLUSH_MS; }
+	uint32_t flashBytesWritten() const { return _flashBytes + _log.bytesWritten(); }
+	// The session log hit a write error and refuses records until the next session;
+	// add*Nut() then return false and nothing is counted
+	bool     logFailed() const { return _log.failed(); }
+	uint32_t logDroppedRecords() const { return _log.droppedRecords(); }
+
 	// Persist batch result
 	bool writeResult(bool passed, float api, float seconds, float rashi, float mangala);
 
@@ -39,20 +90,63 @@ public:
 	// Mark a session closed in-place (used when user chooses "Start New").
 	bool markClosedAtPath(const String& path);
 
-	// Resume newest open session (no result.json); loads counts/last into memory.
+	// Resume the open session named by the session index; loads counts/last into memory.
 bool resumeIfOpen();
 
-// Reclassify the *last* nut; updates counts, rewrites last CSV's override_class,
-// and persists session.json. Returns true on success; sets oldClassOut if provided.
+// Reclassify the *last* nut; updates counts, patches its override_class byte in the
+// session log, and persists session.json. Returns true on success; sets oldClassOut if provided.
 bool reclassifyLast(NutClass newClass, NutClass* oldClassOut = nullptr);
 
+// Same for the nut 'ref' names (taken with lastNutRef() when it was logged), wherever it
+// is in the open session's log. Fails if 'ref' belongs to another session.
+bool reclassifyAt(const NutRef& ref, NutClass newClass, NutClass* oldClassOut = nullptr, uint32_t* indexOut = nullptr);
+NutRef lastNutRef() const { return NutRef{ _lastRecOffset, _sessionTag }; }
+uint16_t sessionTag() const { return _sessionTag; }
+
+// Step back / forward through this session's corrections (newest first, up to
+// SESSION_UNDO_DEPTH). A new reclassifyLast() discards the redo side.
+bool undoCorrection(NutCorrection* out = nullptr);
+bool redoCorrection(NutCorrection* out = nullptr);
+uint8_t undoDepth() const { return _histUndo; }
+uint8_t redoDepth() const { return _histRedo; }
+
+// In-place edits (override patches) made to a session's nuts.bin so far, from the index;
+// 0 if the session is not indexed. flush() the open session first for a current value.
+uint16_t logEdits(const char* id);
+
 private:
 	bool writeSessionJson();
-	bool writeCsvForNut(uint32_t idx, NutClass cls);
+	bool recordNut(NutClass cls, uint8_t confidence, const NutWindow* w, uint8_t flags);
+	bool appendNutRecord(uint32_t idx, NutClass cls, uint8_t confidence, const NutWindow* w, uint8_t flags);
+	void loadLastRecord(uint32_t fromOffset);
+	void markDirty(uint32_t bytes);
+	bool syncIndexEntry();
+	void rebuildIndex();
+	bool applyOverride(uint32_t recOffset, NutClass pred, uint8_t fromOv, uint8_t toOv);
+	bool applyCorrection(const NutCorrection& c, NutClass* oldClassOut);
+	void clearCorrections();
 
 private:
 	bool _open = false;
+	uint16_t _sessionTag = 0;		// bumped whenever a session is started or resumed (NutRef)
 	String _sessionPath;
 	ClassCounts _counts;
 	uint32_t _lastIndex = 0;
+
+	SessionLog _log;				// <session>/nuts.bin
+	uint32_t _lastRecOffset = 0;	// file offset of the last nut record (0 = none)
+	NutClass _lastPred = NutClass::Unknown;
+	uint8_t  _lastOverride = NUT_OVERRIDE_NONE;
+
+	bool     _dirty = false;
+	uint32_t _dirtySinceMs = 0;
+	uint32_t _pendingBytes = 0;
+	uint32_t _flashBytes = 0;		// session.json bytes (log keeps its own count)
+
+	SessionIndex      _index;		// /sessions/index.bin
+	int32_t           _slot = SESSION_SLOT_NONE;
+	SessionIndexEntry _entry = {};	// RAM copy of this session's index entry
+
+	NutCorrection _hist[SESSION_UNDO_DEPTH];	// ring: [_histBase, +_histUndo) undoable, then _histRedo redoable
+	uint8_t _histBase = 0, _histUndo = 0, _histRedo = 0;
 };
@@ -0,0 +1,139 @@
+#include "traceTap.h"
+#include <algorithm>
+#include <atomic>
+
+#ifndef TRACE_READ_TRIES
+#define TRACE_READ_TRIES	4
+#endif
+
+// Shared copies, each guarded by a sequence counter: odd while the producer writes
+static TraceEnvelope liveRing;		// mn/mx/base used as a ring, next write at seq % TRACE_POINTS
+static TraceEnvelope nutTrace;
+static std::atomic<uint32_t> liveLock{0};
+static std::atomic<uint32_t> nutLock{0};
+
+static std::atomic<TraceNotifyFn> notifyFn{nullptr};
+static std::atomic<uint32_t> statReads{0};
+static std::atomic<uint32_t> statTorn{0};
+
+// producer-only state
+static int32_t  curMn = INT32_MAX, curMx = INT32_MIN;
+static uint16_t curN = 0;
+static uint32_t lastNotifyMs = 0;
+
+static inline void writeBegin(std::atomic<uint32_t>& lock) {
+	lock.store(lock.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+static inline void writeEnd(std::atomic<uint32_t>& lock) {
+	lock.store(lock.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+static void notify(bool now) {
+	const TraceNotifyFn fn = notifyFn.load(std::memory_order_relaxed);
+	if (!fn) return;
+	const uint32_t ms = millis();
+	if (!now && ms - lastNotifyMs < TRACE_NOTIFY_MS) return;
+	lastNotifyMs = ms;
+	fn();
+}
+
+/* -------------------- producer (nutPipe task) -------------------- */
+void traceTapSample(int32_t code, int32_t baseline) {
+	if (code < curMn) curMn = code;
+	if (code > curMx) curMx = code;
+	if (++curN < TRACE_LIVE_DECIM) return;
+
+	writeBegin(liveLock);
+	const uint32_t at = liveRing.seq % TRACE_POINTS;
+	liveRing.mn[at]   = curMn;
+	liveRing.mx[at]   = curMx;
+	liveRing.base[at] = baseline;
+	liveRing.seq++;
+	writeEnd(liveLock);
+
+	curMn = INT32_MAX; curMx = INT32_MIN; curN = 0;
+	notify(false);
+}
+
+void traceTapWindow(const NutWindow& w, NutClass cls) {
+	if (w.count == 0) return;
+	const uint16_t per = (w.count + TRACE_POINTS - 1) / TRACE_POINTS;
+
+	writeBegin(nutLock);
+	uint16_t p = 0;
+	for (uint16_t i = 0; i < w.count; i += per, ++p) {
+		const uint16_t end = (uint16_t)(i + per) < w.count ? i + per : w.count;
+		int32_t mn = w.samples[i], mx = w.samples[i];
+		for (uint16_t k = i + 1; k < end; ++k) {
+			if (w.samples[k] < mn) mn = w.samples[k];
+			if (w.samples[k] > mx) mx = w.samples[k];
+		}
+		nutTrace.mn[p]   = mn;
+		nutTrace.mx[p]   = mx;
+		nutTrace.base[p] = w.baseline;
+	}
+	nutTrace.points       = p;
+	nutTrace.perPoint     = per;
+	nutTrace.triggerPoint = w.triggerIdx / per;
+	nutTrace.cls          = (uint8_t)cls;
+	nutTrace.seq++;
+	writeEnd(nutLock);
+
+	notify(true);
+}
+
+/* -------------------- readers -------------------- */
+static void summarize(TraceEnvelope& e) {
+	e.lo = INT32_MAX; e.hi = INT32_MIN; e.saturated = false;
+	for (uint16_t i = 0; i < e.points; ++i) {
+		if (e.mn[i] < e.lo) e.lo = e.mn[i];
+		if (e.mx[i] > e.hi) e.hi = e.mx[i];
+	}
+	if (e.points) e.saturated = e.hi >= TRACE_SAT_CODE || e.lo <= -TRACE_SAT_CODE;
+	else          e.lo = e.hi = 0;
+}
+
+static bool readConsistent(const std::atomic<uint32_t>& lock, const TraceEnvelope& src, TraceEnvelope& out) {
+	statReads.fetch_add(1, std::memory_order_relaxed);
+	for (uint8_t t = 0; t < TRACE_READ_TRIES; ++t) {
+		const uint32_t s0 = lock.load(std::memory_order_acquire);
+		if (s0 & 1) continue;
+		memcpy(&out, &src, sizeof(out));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (lock.load(std::memory_order_relaxed) == s0) return true;
+	}
+	statTorn.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+bool traceTapReadLive(TraceEnvelope& out) {
+	if (!readConsistent(liveLock, liveRing, out)) return false;
+	if (out.seq >= TRACE_POINTS) {		// ring is full: rotate the oldest point to the front
+		const uint32_t head = out.seq % TRACE_POINTS;
+		std::rotate(out.mn,   out.mn + head,   out.mn + TRACE_POINTS);
+		std::rotate(out.mx,   out.mx + head,   out.mx + TRACE_POINTS);
+		std::rotate(out.base, out.base + head, out.base + TRACE_POINTS);
+		out.points = TRACE_POINTS;
+	} else {
+		out.points = out.seq;
+	}
+	out.perPoint = TRACE_LIVE_DECIM;
+	summarize(out);
+	return true;
+}
+
+bool traceTapReadNut(TraceEnvelope& out) {
+	if (!readConsistent(nutLock, nutTrace, out)) return false;
+	summarize(out);
+	return true;
+}
+
+void traceTapSetNotify(TraceNotifyFn fn) { notifyFn.store(fn); }
+
+TraceTapStats traceTapGetStats() {
+	TraceTapStats st;
+	st.reads = statReads.load(std::memory_order_relaxed);
+	st.torn  = statTorn.load(std::memory_order_relaxed);
+	return st;
+}
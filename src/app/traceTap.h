@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include "app/nutClass.h"
+#include "dsp/nutSegmenter.h"
+
+/* Decimated ADC traces for the on-screen scope (producer: nutPipe task)
+ *
+ * - Live: every TRACE_LIVE_DECIM samples fold into one min/max point (plus the segmenter
+ *   baseline at that moment) in a ring of TRACE_POINTS, so the chart shows the last
+ *   TRACE_POINTS * TRACE_LIVE_DECIM samples whatever the data rate
+ * - Nut: each published window is folded into at most TRACE_POINTS min/max points
+ * - Both are published under a sequence counter (seqlock): the producer never waits,
+ *   a reader that overlaps a write retries and finally gives up (counted as torn)
+ * - While a notify callback is set it is called from the producer at most every
+ *   TRACE_NOTIFY_MS, and right after a nut window
+ */
+
+#ifndef TRACE_POINTS
+#define TRACE_POINTS		120		// chart points (2 px each on a 240 px wide screen)
+#endif
+#ifndef TRACE_LIVE_DECIM
+#define TRACE_LIVE_DECIM	16		// samples per live point: 120 x 16 = 0.96 s at 2 kSPS
+#endif
+#ifndef TRACE_NOTIFY_MS
+#define TRACE_NOTIFY_MS		100
+#endif
+#ifndef TRACE_SAT_CODE
+#define TRACE_SAT_CODE		8380000	// |code| at or above this is treated as clipped (24-bit full scale 8388607)
+#endif
+
+struct TraceEnvelope {
+	int32_t  mn[TRACE_POINTS];	// oldest first
+	int32_t  mx[TRACE_POINTS];
+	int32_t  base[TRACE_POINTS];	// segmenter baseline per point (nut: frozen at the trigger)
+	uint16_t points;			// valid points
+	uint16_t perPoint;			// samples folded into each point
+	uint16_t triggerPoint;		// nut: point holding the trigger sample
+	uint8_t  cls;				// nut: NutClass from the classifier
+	uint32_t seq;				// live: points produced since boot; nut: windows traced
+	// filled in by the readers
+	int32_t  lo, hi;
+	bool     saturated;
+};
+
+// nutPipe task
+void traceTapSample(int32_t code, int32_t baseline);
+void traceTapWindow(const NutWindow& w, NutClass cls);
+
+// Any task. Return false if no consistent copy could be taken (writer kept overlapping).
+bool traceTapReadLive(TraceEnvelope& out);
+bool traceTapReadNut(TraceEnvelope& out);
+
+// Called on the nutPipe task; must not block. nullptr stops notifications.
+typedef void (*TraceNotifyFn)();
+void traceTapSetNotify(TraceNotifyFn fn);
+
+struct TraceTapStats { uint32_t reads; uint32_t torn; };
+TraceTapStats traceTapGetStats();
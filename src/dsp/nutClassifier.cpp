@@ -0,0 +1,59 @@
+#include "nutClassifier.h"
+
+/* Default centroids (flash-resident). PLACEHOLDER values shaped like typical cracks;
+ * refit them from operator-labelled session logs before trusting the counts.
+ * Spreads used for the weights: log2 peak 96 (Q8), rise 3, width 10, slope 15, zc 3. */
+constexpr NutCentroidModel kNutDefaultModel = {
+	{
+		//  log2pk  rise  width  slope  zc
+		{    4403,    6,    40,   -60,   8 },	// Api
+		{    4064,   10,    25,   -90,   4 },	// Seconds
+		{    4252,    8,    60,   -40,  12 },	// Rashi
+		{    3807,   14,    80,   -20,  16 },	// Mangala
+	},
+	{ 683, 21845, 6554, 4369, 21845 },	// 65536 / spread  ->  one spread == 256 units
+	16u * 65536u,						// farther than 4 spreads (RMS-ish) from everything -> Unknown
+};
+
+// log2(v) in Q8: integer part from the MSB, fraction from the next 8 mantissa bits
+static int32_t log2Q8(uint32_t v) {
+	if (v == 0) return 0;
+	const int32_t e = 31 - __builtin_clz(v);
+	const uint32_t mant = (e >= 8) ? (v >> (e - 8)) & 0xFF : (v << (8 - e)) & 0xFF;
+	return (e << 8) | (int32_t)mant;
+}
+
+void nutFeatureVector(const NutFeatures& f, int32_t out[NUT_FEATURE_DIMS]) {
+	out[0] = log2Q8((uint32_t)f.peak);
+	out[1] = f.riseSamples;
+	out[2] = f.peak > 0 ? (int32_t)(f.area / (uint32_t)f.peak) : 0;
+	out[3] = f.decaySlopeQ15 >> 4;
+	out[4] = f.zeroCrossings;
+}
+
+ClassifyResult CentroidClassifier::classify(const NutFeatures& f) const {
+	int32_t v[NUT_FEATURE_DIMS];
+	nutFeatureVector(f, v);
+
+	uint32_t d1 = UINT32_MAX, d2 = UINT32_MAX;
+	uint8_t  best = 0;
+	for (uint8_t c = 0; c < NUT_MODEL_CLASSES; ++c) {
+		uint32_t dist = 0;
+		for (uint8_t k = 0; k < NUT_FEATURE_DIMS; ++k) {
+			int32_t diff = ((v[k] - _model.centroid[c][k]) * (int32_t)_model.weightQ8[k]) >> 8;
+			if (diff >  4095) diff =  4095;	// clamp at 16 spreads so the sum stays in 32 bits
+			if (diff < -4095) diff = -4095;
+			dist += (uint32_t)(diff * diff);
+		}
+		if (dist < d1)      { d2 = d1; d1 = dist; best = c; }
+		else if (dist < d2) { d2 = dist; }
+	}
+
+	ClassifyResult r;
+	r.best = (NutClass)best;
+	// margin between winner and runner-up: 255 = unambiguous, 0 = tie
+	const uint64_t sum = (uint64_t)d1 + d2;
+	r.confidence = sum ? (uint8_t)(((uint64_t)(d2 - d1) * 255u) / sum) : 0;
+	r.cls = (r.confidence < _minConf || d1 > _model.maxDistance) ? NutClass::Unknown : r.best;
+	return r;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include "app/nutClass.h"
+#include "nutFeatures.h"
+
+/* On-device nut classifier
+ * - Classifier is the engine interface; CentroidClassifier is the default model
+ * - Features are mapped to a small integer vector, then matched against per-class centroids
+ *   with a weighted squared distance (integer only, a few hundred cycles per nut)
+ * - Confidence is the margin between the best and runner-up class (0..255);
+ *   below minConfidence, or too far from every centroid, the result is NutClass::Unknown
+ */
+
+#ifndef NUT_CLASSIFY_MIN_CONF
+#define NUT_CLASSIFY_MIN_CONF	64		// 0..255; below this the operator is asked
+#endif
+
+struct ClassifyResult {
+	NutClass cls;
+	uint8_t  confidence;	// 0..255
+	NutClass best;			// nearest class even when cls was demoted to Unknown
+};
+
+class Classifier {
+public:
+	virtual ~Classifier() {}
+	virtual ClassifyResult classify(const NutFeatures& f) const = 0;
+};
+
+// ---- nearest-centroid model (tables live in flash) ----
+static const uint8_t NUT_FEATURE_DIMS = 5;
+static const uint8_t NUT_MODEL_CLASSES = 4;	// Api, Seconds, Rashi, Mangala (NutClass order)
+
+struct NutCentroidModel {
+	int32_t  centroid[NUT_MODEL_CLASSES][NUT_FEATURE_DIMS];
+	uint16_t weightQ8[NUT_FEATURE_DIMS];	// per-dimension 1/spread, Q8
+	uint32_t maxDistance;					// nearest centroid farther than this -> Unknown
+};
+
+// Feature vector: [log2(peak) Q8, rise samples, width = area/peak, decay slope Q15 >> 4, zero crossings]
+void nutFeatureVector(const NutFeatures& f, int32_t out[NUT_FEATURE_DIMS]);
+
+class CentroidClassifier : public Classifier {
+public:
+	explicit CentroidClassifier(const NutCentroidModel& model, uint8_t minConfidence = NUT_CLASSIFY_MIN_CONF)
+		: _model(model), _minConf(minConfidence) {}
+	ClassifyResult classify(const NutFeatures& f) const override;
+
+private:
+	const NutCentroidModel& _model;
+	uint8_t _minConf;
+};
+
+extern const NutCentroidModel kNutDefaultModel;
@@ -0,0 +1,123 @@
+#include "nutFeatures.h"
+
+// den = N^2 (N^2 - 1) / 12 < 2^44 for N <= 4096, so the remainder term below stays in 64 bits
+static_assert(NUT_WINDOW_MAX <= 4096, "slope fixed-point headroom");
+
+// num * 32768 / den without the 64-bit overflow of forming num * 32768 directly
+static inline int64_t mulQ15Div(int64_t num, int64_t den) {
+	return (num / den) * 32768 + ((num % den) * 32768) / den;
+}
+
+void nutFeaturesExtract(const NutWindow& w, NutFeatures& out) {
+	const int32_t  base = w.baseline;
+	const int32_t* x    = w.samples;
+	const uint16_t cnt  = w.count;
+
+	int32_t  peak = -1;
+	uint16_t peakIdx = 0;
+	uint64_t area = 0, energy = 0;
+	uint16_t zc = 0;
+	int8_t   sign = 0;
+
+	// |d| vs distance-from-peak regression; restarted whenever a new peak shows up
+	uint32_t n = 0;
+	int64_t  sy = 0, sny = 0;
+
+	for (uint16_t i = 0; i < cnt; ++i) {
+		const int32_t d = x[i] - base;
+		const int32_t a = d < 0 ? -d : d;
+
+		area   += (uint32_t)a;
+		energy += (uint64_t)((int64_t)d * d);
+
+		if (a > peak) {
+			peak = a; peakIdx = i;
+			n = 0; sy = 0; sny = 0;
+		} else {
+			++n;
+			sy  += a;
+			sny += (int64_t)n * a;
+		}
+
+		if      (d >  NUT_ZC_HYST) { if (sign < 0) ++zc; sign =  1; }
+		else if (d < -NUT_ZC_HYST) { if (sign > 0) ++zc; sign = -1; }
+	}
+
+	// slope = (N*Sny - Sn*Sy) / (N*Snn - Sn^2), with Sn/Snn in closed form for n = 1..N
+	int32_t slopeQ15 = 0;
+	if (n >= 2 && peak > 0) {
+		const int64_t N   = n;
+		const int64_t sn  = N * (N + 1) / 2;
+		const int64_t snn = N * (N + 1) * (2 * N + 1) / 6;
+		const int64_t num = N * sny - sn * sy;
+		const int64_t den = N * snn - sn * sn;
+		const int64_t q   = mulQ15Div(num, den) / peak;	// scale before dividing: short tails keep their precision
+		slopeQ15 = q < -32768 ? -32768 : (q > 32767 ? 32767 : (int32_t)q);
+	}
+
+	out.peak          = peak < 0 ? 0 : peak;
+	out.peakIdx       = peakIdx;
+	out.riseSamples   = peakIdx > w.triggerIdx ? (uint16_t)(peakIdx - w.triggerIdx) : 0;
+	out.area          = area;
+	out.energy        = energy;
+	out.decaySlopeQ15 = (int16_t)slopeQ15;
+	out.zeroCrossings = zc;
+	out.count         = cnt;
+}
+
+#ifdef NUT_FEATURES_REFERENCE
+#include <math.h>
+
+void nutFeaturesReference(const NutWindow& w, NutFeaturesRef& out) {
+	double peak = -1.0, area = 0.0, energy = 0.0;
+	int    peakIdx = 0, zc = 0, sign = 0;
+
+	for (int i = 0; i < w.count; ++i) {
+		const double d = (double)w.samples[i] - (double)w.baseline;
+		const double a = fabs(d);
+		area += a; energy += d * d;
+		if (a > peak) { peak = a; peakIdx = i; }
+		if      (d >  NUT_ZC_HYST) { if (sign < 0) ++zc; sign =  1; }
+		else if (d < -NUT_ZC_HYST) { if (sign > 0) ++zc; sign = -1; }
+	}
+
+	// straightforward two-pass least squares over the samples after the peak
+	double slope = 0.0;
+	const int N = w.count - 1 - peakIdx;
+	if (N >= 2 && peak > 0.0) {
+		double mx = 0.0, my = 0.0;
+		for (int k = 1; k <= N; ++k) { mx += k; my += fabs((double)w.samples[peakIdx + k] - w.baseline); }
+		mx /= N; my /= N;
+		double sxy = 0.0, sxx = 0.0;
+		for (int k = 1; k <= N; ++k) {
+			const double y = fabs((double)w.samples[peakIdx + k] - w.baseline);
+			sxy += (k - mx) * (y - my);
+			sxx += (k - mx) * (k - mx);
+		}
+		slope = (sxy / sxx) / peak;
+	}
+
+	out.peak          = peak < 0.0 ? 0.0 : peak;
+	out.peakIdx       = peakIdx;
+	out.riseSamples   = peakIdx > w.triggerIdx ? peakIdx - w.triggerIdx : 0;
+	out.area          = area;
+	out.energy        = energy;
+	out.decaySlope    = slope;
+	out.zeroCrossings = zc;
+}
+
+static bool closeRel(double a, double b, double tol) {
+	const double m = fabs(b) > 1.0 ? fabs(b) : 1.0;
+	return fabs(a - b) <= tol * m;
+}
+
+bool nutFeaturesMatchReference(const NutFeatures& f, const NutFeaturesRef& r) {
+	if (f.peakIdx != r.peakIdx || f.riseSamples != r.riseSamples || f.zeroCrossings != r.zeroCrossings) return false;
+	if (!closeRel(f.peak, r.peak, 0.005))                 return false;
+	if (!closeRel((double)f.area, r.area, 0.005))         return false;
+	if (!closeRel((double)f.energy, r.energy, 0.005))     return false;
+	// Q15 resolution is ~3e-5 of peak per sample; allow 2 LSB on top of the relative error
+	const double slope = f.decaySlopeQ15 / 32768.0;
+	return fabs(slope - r.decaySlope) <= 0.005 * fabs(r.decaySlope) + 2.0 / 32768.0;
+}
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include "nutSegmenter.h"
+
+/* Single-pass, integer-only feature kernel for one segmented nut window
+ * - Works on d = adc_code - baseline (the same columns the session log stores)
+ * - No float, no division inside the loop; the decay slope takes a few 64-bit divisions at the end
+ * - Build with -D NUT_FEATURES_REFERENCE to get a double-precision reference for checking
+ */
+
+#ifndef NUT_ZC_HYST
+#define NUT_ZC_HYST	2000	// codes; |d| must exceed this to count as a new sign for zero crossings
+#endif
+
+struct NutFeatures {
+	int32_t  peak;			// max |d| (codes)
+	uint16_t peakIdx;		// sample index of the peak
+	uint16_t riseSamples;	// trigger -> peak
+	uint64_t area;			// sum |d|
+	uint64_t energy;		// sum d^2
+	int16_t  decaySlopeQ15;	// least-squares slope of |d| after the peak, per sample, as a fraction of peak (Q15)
+	uint16_t zeroCrossings;	// sign changes of d (with NUT_ZC_HYST hysteresis)
+	uint16_t count;			// samples in the window
+};
+
+void nutFeaturesExtract(const NutWindow& w, NutFeatures& out);
+
+#ifdef NUT_FEATURES_REFERENCE
+struct NutFeaturesRef {
+	double peak, area, energy, decaySlope;	// decaySlope as a fraction of peak per sample
+	int    peakIdx, riseSamples, zeroCrossings;
+};
+void nutFeaturesReference(const NutWindow& w, NutFeaturesRef& out);
+
+// true if the integer kernel agrees with the reference (exact counts, <0.5% on the rest)
+bool nutFeaturesMatchReference(const NutFeatures& f, const NutFeaturesRef& r);
+#endif
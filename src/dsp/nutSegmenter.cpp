@@ -0,0 +1,89 @@
+#include "nutSegmenter.h"
+
+static_assert((NUT_PRE_MAX & (NUT_PRE_MAX - 1)) == 0, "NUT_PRE_MAX must be a power of two");
+
+static inline int32_t absDev(int32_t v) { return v < 0 ? -v : v; }
+
+void NutSegmenter::begin(const NutSegmenterConfig& cfg) {
+	_cfg = cfg;
+	if (_cfg.preTrigger > NUT_PRE_MAX) _cfg.preTrigger = NUT_PRE_MAX;
+	if (_cfg.preTrigger >= NUT_WINDOW_MAX) _cfg.preTrigger = NUT_WINDOW_MAX / 2;
+	if (_cfg.baselineShift > 16) _cfg.baselineShift = 16;
+	if (_cfg.releaseLevel > _cfg.threshold) _cfg.releaseLevel = _cfg.threshold;
+
+	_state = State::Warmup;
+	_baseAcc = 0;
+	_warm = _quiet = _hold = 0;
+	_preHead = 0;
+	_win.count = 0;
+}
+
+void NutSegmenter::openWindow(uint32_t tUs, int32_t code) {
+	_win.baseline  = baseline();
+	_win.truncated = false;
+	_win.count     = 0;
+
+	// replay the pre-trigger history, oldest first
+	const uint32_t pre = _preHead < _cfg.preTrigger ? _preHead : _cfg.preTrigger;
+	for (uint32_t i = _preHead - pre; i != _preHead; ++i) {
+		const uint32_t k = i & (NUT_PRE_MAX - 1);
+		if (_win.count == 0) _win.tStartUs = _preTime[k];
+		_win.samples[_win.count++] = _preCode[k];
+	}
+	if (_win.count == 0) _win.tStartUs = tUs;
+
+	_win.triggerIdx = _win.count;
+	_win.samples[_win.count++] = code;
+	_win.tEndUs = tUs;
+
+	_quiet = 0;
+	_state = State::Capture;
+}
+
+bool NutSegmenter::closeWindow(bool truncated) {
+	_win.truncated = truncated;
+	if (truncated) _truncated++;
+	_emitted++;
+
+	_preHead = 0;	// history before/inside this window must not leak into the next one
+	_hold = _cfg.holdOff;
+	_state = _hold ? State::HoldOff : State::Idle;
+	return true;
+}
+
+bool NutSegmenter::push(uint32_t tUs, int32_t code) {
+	const uint8_t sh = _cfg.baselineShift;
+
+	if (_state == State::Capture) {
+		_win.samples[_win.count++] = code;
+		_win.tEndUs = tUs;
+
+		if (absDev(code - _win.baseline) < _cfg.releaseLevel) _quiet++;
+		else                                                  _quiet = 0;
+
+		if (_quiet >= _cfg.postTrigger) return closeWindow(false);
+		if (_win.count >= NUT_WINDOW_MAX) return closeWindow(true);
+		return false;
+	}
+
+	if (_state == State::Warmup && _warm == 0) _baseAcc = (int64_t)code << sh;
+
+	if (_state == State::Idle && absDev(code - baseline()) >= _cfg.threshold) {
+		openWindow(tUs, code);
+		return false;
+	}
+
+	// track baseline + keep pre-trigger history (Warmup / Idle / HoldOff)
+	_baseAcc += code - (_baseAcc >> sh);
+	const uint32_t k = _preHead++ & (NUT_PRE_MAX - 1);
+	_preCode[k] = code;
+	_preTime[k] = tUs;
+
+	if (_state == State::Warmup) {
+		const uint32_t warmLen = 1u << (sh < 12 ? sh : 12);
+		if (++_warm >= warmLen) _state = State::Idle;
+	} else if (_state == State::HoldOff) {
+		if (--_hold == 0) _state = State::Idle;
+	}
+	return false;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+
+/* Streaming crack-event segmenter (no Arduino deps, no heap)
+ * - Tracks the resting baseline with an integer EMA: b += (x - b) >> baselineShift (O(1))
+ * - Opens a window when |x - baseline| >= threshold; the last preTrigger samples are prepended
+ * - Closes once |x - baseline| stays below releaseLevel for postTrigger samples
+ *   (or the window is full), then ignores holdOff samples before re-arming
+ * - Baseline is frozen while a window is open so the crack itself does not drag it
+ */
+
+#ifndef NUT_WINDOW_MAX
+#define NUT_WINDOW_MAX	1024	// samples per nut (512 ms at 2 kSPS)
+#endif
+#ifndef NUT_PRE_MAX
+#define NUT_PRE_MAX		128		// upper bound for preTrigger (power of two)
+#endif
+
+struct NutSegmenterConfig {
+	int32_t  threshold     = 20000;	// trigger level, ADC codes above/below baseline
+	int32_t  releaseLevel  = 10000;	// hysteresis: "quiet" means below this
+	uint16_t preTrigger    = 64;	// samples kept from before the trigger (<= NUT_PRE_MAX)
+	uint16_t postTrigger   = 200;	// quiet samples needed to close a window
+	uint16_t holdOff       = 100;	// refractory samples after a window closes
+	uint8_t  baselineShift = 10;	// EMA time constant = 2^shift samples
+
+	// Upper bound on throughput: the shortest possible nut is pre + 1 + post samples, plus hold-off
+	uint32_t maxNutsPerMinute(uint32_t sampleRateHz) const {
+		return (60u * sampleRateHz) / ((uint32_t)preTrigger + 1u + postTrigger + holdOff);
+	}
+};
+
+struct NutWindow {
+	uint32_t tStartUs;		// timestamp of samples[0]
+	uint32_t tEndUs;		// timestamp of samples[count - 1]
+	int32_t  baseline;		// baseline frozen at the trigger
+	uint16_t count;			// valid samples
+	uint16_t triggerIdx;	// index of the first sample that crossed the threshold
+	bool     truncated;		// window filled up before the signal went quiet
+	int32_t  samples[NUT_WINDOW_MAX];
+
+	// Average sample spacing (uniform at a fixed ADC data rate)
+	uint32_t periodUs() const { return count > 1 ? (tEndUs - tStartUs) / (count - 1u) : 0; }
+};
+
+class NutSegmenter {
+public:
+	void begin(const NutSegmenterConfig& cfg);
+	const NutSegmenterConfig& config() const { return _cfg; }
+
+	// Feed one sample. Returns true when a complete window is ready in window();
+	// the window stays valid until the next push().
+	bool push(uint32_t tUs, int32_t code);
+
+	const NutWindow& window() const { return _win; }
+	int32_t baseline() const { return (int32_t)(_baseAcc >> _cfg.baselineShift); }
+	bool    inWindow() const { return _state == State::Capture; }
+
+	uint32_t windowsEmitted() const { return _emitted; }
+	uint32_t windowsTruncated() const { return _truncated; }
+
+private:
+	enum class State : uint8_t { Warmup, Idle, Capture, HoldOff };
+
+	void openWindow(uint32_t tUs, int32_t code);
+	bool closeWindow(bool truncated);
+
+	NutSegmenterConfig _cfg;
+	State    _state = State::Warmup;
+	int64_t  _baseAcc = 0;		// baseline << baselineShift
+	uint32_t _warm = 0;
+	uint32_t _quiet = 0;		// consecutive quiet samples inside a window
+	uint32_t _hold = 0;
+
+	// pre-trigger history
+	int32_t  _preCode[NUT_PRE_MAX];
+	uint32_t _preTime[NUT_PRE_MAX];
+	uint32_t _preHead = 0;		// total samples written (free-running)
+
+	NutWindow _win;
+	uint32_t _emitted = 0;
+	uint32_t _truncated = 0;
+};
@@ -0,0 +1,113 @@
+#include "atomicFile.h"
+#include "fsCompat.h"
+#include "crc32.h"
+#include "app/metrics.h"
+
+static bool parseHeader(const char* h, uint32_t& seq, uint32_t& len, uint32_t& crc) {
+	if (memcmp(h, "#NC1 ", 5) != 0 || h[ATOMIC_HEADER_LEN - 1] != '\n') return false;
+	char tmp[ATOMIC_HEADER_LEN + 1];
+	memcpy(tmp, h, ATOMIC_HEADER_LEN); tmp[ATOMIC_HEADER_LEN] = 0;
+	unsigned s = 0, l = 0, c = 0;
+	if (sscanf(tmp + 5, "%8x %8x %8x", &s, &l, &c) != 3) return false;
+	seq = s; len = l; crc = c;
+	return true;
+}
+
+// Validate one candidate; on success leaves the payload in buf and returns its length
+static int readCandidate(const String& path, char* buf, size_t cap, uint32_t& seqOut) {
+	fs::File f = FSYS.open(path, "r");
+	if (!f) return -1;
+	const size_t size = f.size();
+	char hdr[ATOMIC_HEADER_LEN];
+	const size_t got = f.read((uint8_t*)hdr, size < ATOMIC_HEADER_LEN ? size : ATOMIC_HEADER_LEN);
+
+	uint32_t seq = 0, len = 0, crc = 0;
+	int result = -1;
+	if (got == ATOMIC_HEADER_LEN && parseHeader(hdr, seq, len, crc)) {
+		if (size == ATOMIC_HEADER_LEN + len && len < cap
+		    && f.read((uint8_t*)buf, len) == len && crc32Update(0, buf, len) == crc) {
+			buf[len] = 0;
+			seqOut = seq;
+			result = (int)len;
+		}
+	} else if (size > 0 && size < cap && got > 0 && hdr[0] == '{') {
+		// legacy file (no header): trust it, but below any versioned copy
+		memcpy(buf, hdr, got);
+		if (f.read((uint8_t*)buf + got, size - got) == size - got) {
+			buf[size] = 0;
+			seqOut = 0;
+			result = (int)size;
+		}
+	}
+	f.close();
+	return result;
+}
+
+// Seq of the last committed write: <path> holds it, or .bak if power was cut between the
+// two renames. A leftover .tmp needs no look: the next write overwrites it first.
+static uint32_t currentSeq(const String& path) {
+	for (const String& n : { path, path + ".bak" }) {
+		fs::File f = FSYS.open(n, "r");
+		if (!f) continue;
+		char hdr[ATOMIC_HEADER_LEN];
+		uint32_t seq, len, crc;
+		const bool ok = f.read((uint8_t*)hdr, ATOMIC_HEADER_LEN) == ATOMIC_HEADER_LEN
+		             && parseHeader(hdr, seq, len, crc);
+		f.close();
+		if (ok) return seq;
+	}
+	return 0;
+}
+
+bool atomicWriteFile(const String& path, const void* data, size_t len) {
+	const String tmp = path + ".tmp";
+	const uint32_t seq = currentSeq(path) + 1;
+
+	char hdr[ATOMIC_HEADER_LEN + 1];
+	snprintf(hdr, sizeof(hdr), "#NC1 %08x %08x %08x\n",
+		(unsigned)seq, (unsigned)len, (unsigned)crc32Update(0, data, len));
+
+	const uint32_t t0 = micros();
+	fs::File f = FSYS.open(tmp, "w");
+	if (!f) {
+		Serial.printf("[ATOMIC] open failed: %s\n", tmp.c_str());
+		return false;
+	}
+	bool ok = f.write((const uint8_t*)hdr, ATOMIC_HEADER_LEN) == ATOMIC_HEADER_LEN
+	       && f.write((const uint8_t*)data, len) == len;
+	f.close();
+	if (!ok) {
+		Serial.printf("[ATOMIC] short write: %s\n", tmp.c_str());
+		return false;
+	}
+
+	// keep the previous good copy as .bak, then promote the new one
+	if (FSYS.exists(path) && !FSYS.rename(path, path + ".bak")) return false;
+	ok = FSYS.rename(tmp, path);
+	metricFsOpUs[METRIC_FS_JSON].observe(micros() - t0);
+	metricFlashBytes[METRIC_FS_JSON].inc(ATOMIC_HEADER_LEN + len);
+	return ok;
+}
+
+int atomicReadFile(const String& path, char* buf, size_t cap) {
+	const String names[3] = { path, path + ".bak", path + ".tmp" };
+	int bestLen = -1; uint32_t bestSeq = 0; int bestIdx = -1;
+	for (int i = 0; i < 3; ++i) {
+		uint32_t seq = 0;
+		const int n = readCandidate(names[i], buf, cap, seq);
+		if (n >= 0 && (bestIdx < 0 || seq > bestSeq)) { bestIdx = i; bestSeq = seq; bestLen = n; }
+	}
+	if (bestIdx < 0) return -1;
+	if (bestIdx != 2) {
+		// buf holds the last candidate read; reload the winner
+		uint32_t seq = 0;
+		bestLen = readCandidate(names[bestIdx], buf, cap, seq);
+	}
+	return bestLen;
+}
+
+void atomicRemoveFile(const String& path) {
+	FSYS.remove(path);
+	FSYS.remove(path + ".bak");
+	FSYS.remove(path + ".tmp");
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <Arduino.h>
+
+/* Crash-consistent small-file writes (session.json, result.json)
+ * - Content is prefixed with a 32-byte text header: "#NC1 <seq> <len> <crc32>\n" (hex)
+ * - Write: <path>.tmp -> rename <path> to <path>.bak -> rename <path>.tmp to <path>
+ *   (LittleFS renames are atomic), so every crash point leaves at least one valid copy
+ * - Read: the valid copy (CRC + length) with the highest seq among <path>, .bak, .tmp wins;
+ *   files without a header (written before this format) are accepted as seq 0
+ * - Nothing here forces a sync per call; callers batch writes (see SessionManager::flush)
+ */
+
+static const size_t ATOMIC_HEADER_LEN = 32;
+
+// Replace 'path' with 'data'. Returns false if the new copy could not be committed.
+bool atomicWriteFile(const String& path, const void* data, size_t len);
+
+// Read the newest valid copy into 'buf' (NUL-terminated if room). Returns payload length,
+// or -1 if no valid copy exists or it does not fit in 'cap'.
+int atomicReadFile(const String& path, char* buf, size_t cap);
+
+// Remove 'path' and its .bak/.tmp siblings
+void atomicRemoveFile(const String& path);
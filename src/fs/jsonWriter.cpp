@@ -0,0 +1,105 @@
+#include "jsonWriter.h"
+
+/* -------------------- BufferPrint -------------------- */
+size_t BufferPrint::write(const uint8_t* p, size_t n) {
+	if (_cap == 0) { _overflow = _overflow || n; return 0; }
+	const size_t room = _cap - 1 - _len;
+	const size_t k = n < room ? n : room;
+	memcpy(_buf + _len, p, k);
+	_len += k;
+	_buf[_len] = 0;
+	if (k < n) _overflow = true;
+	return k;
+}
+
+/* -------------------- JsonWriter -------------------- */
+void JsonWriter::comma() {
+	if (_afterKey) { _afterKey = false; return; }	// value directly follows its key
+	const uint32_t bit = 1u << (_depth & 31);
+	if (_hasItem & bit) put(',');
+	_hasItem |= bit;
+}
+
+JsonWriter& JsonWriter::open(const char* k, char c) {
+	if (k) key(k);
+	comma();	// consumes the key, or separates array items
+	put(c);
+	_depth++;
+	_hasItem &= ~(1u << (_depth & 31));
+	return *this;
+}
+
+JsonWriter& JsonWriter::close(char c) {
+	if (_depth) _depth--;
+	put(c);
+	return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* k) {
+	comma();
+	put('"'); escaped(k); put("\":");
+	_afterKey = true;
+	return *this;
+}
+
+void JsonWriter::escaped(const char* s) {
+	static const char hex[] = "0123456789abcdef";
+	const char* run = s;
+	for (; *s; ++s) {
+		const uint8_t c = (uint8_t)*s;
+		if (c >= 0x20 && c != '"' && c != '\\') continue;
+		if (s > run) _bytes += _out.write((const uint8_t*)run, s - run);
+		put('\\');
+		switch (c) {
+			case '"':  put('"'); break;
+			case '\\': put('\\'); break;
+			case '\n': put('n'); break;
+			case '\r': put('r'); break;
+			case '\t': put('t'); break;
+			default:   put("u00"); put(hex[c >> 4]); put(hex[c & 15]); break;
+		}
+		run = s + 1;
+	}
+	if (s > run) _bytes += _out.write((const uint8_t*)run, s - run);
+}
+
+JsonWriter& JsonWriter::value(const char* s) {
+	comma();
+	if (!s) { put("null"); return *this; }
+	put('"'); escaped(s); put('"');
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+	comma();
+	put(b ? "true" : "false");
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long v) {
+	comma();
+	_bytes += _out.print(v);
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(long v) {
+	comma();
+	_bytes += _out.print(v);
+	return *this;
+}
+
+JsonWriter& JsonWriter::value1(float v) {
+	comma();
+	int32_t t = (int32_t)(v * 10.0f + (v < 0 ? -0.5f : 0.5f));	// tenths, rounded half away from zero
+	if (t < 0) { put('-'); t = -t; }
+	_bytes += _out.print((unsigned long)(t / 10));
+	put('.');
+	put((char)('0' + t % 10));
+	return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+	comma();
+	put("null");
+	return *this;
+}
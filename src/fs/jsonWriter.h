@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+
+/* Streaming JSON emitter over any Print (BufferPrint, fs::File, response streams);
+ * used for HTTP responses, SSE payloads and the persisted session/result files
+ * - No heap: numbers go through Print's stack formatting, strings are escaped in place
+ * - Commas are tracked per nesting level (up to 31 levels)
+ * - Decimal values are fixed-point (value1: one decimal), no printf/float formatting
+ *
+ *   BufferPrint out(buf, sizeof(buf));
+ *   JsonWriter js(out);
+ *   js.beginObject().field("ok", true).beginObject("counts").field("Api", 3u).endObject().endObject();
+ */
+
+// Print into a caller-owned char buffer; always NUL-terminated, flags truncation
+class BufferPrint : public Print {
+public:
+	BufferPrint(char* buf, size_t cap) : _buf(buf), _cap(cap) { clear(); }
+
+	size_t write(uint8_t c) override { return write(&c, 1); }
+	size_t write(const uint8_t* p, size_t n) override;
+
+	void clear() { _len = 0; _overflow = false; if (_cap) _buf[0] = 0; }
+	const char* c_str() const { return _buf; }
+	size_t length() const { return _len; }
+	bool overflow() const { return _overflow; }
+
+private:
+	char*  _buf;
+	size_t _cap;
+	size_t _len = 0;
+	bool   _overflow = false;
+};
+
+class JsonWriter {
+public:
+	explicit JsonWriter(Print& out) : _out(out) {}
+
+	JsonWriter& beginObject(const char* key = nullptr) { return open(key, '{'); }
+	JsonWriter& endObject() { return close('}'); }
+	JsonWriter& beginArray(const char* key = nullptr) { return open(key, '['); }
+	JsonWriter& endArray() { return close(']'); }
+
+	JsonWriter& key(const char* k);
+
+	// values (in an array, or after key())
+	JsonWriter& value(const char* s);				// escaped string
+	JsonWriter& value(bool b);
+	JsonWriter& value(unsigned long v);
+	JsonWriter& value(long v);
+	JsonWriter& value(unsigned v) { return value((unsigned long)v); }	// covers uint32_t either way
+	JsonWriter& value(int v) { return value((long)v); }
+	JsonWriter& value1(float v);					// one decimal, e.g. 12.5
+	JsonWriter& null();
+
+	// key + value
+	template <typename T>
+	JsonWriter& field(const char* k, T v) { key(k); return value(v); }
+	JsonWriter& field1(const char* k, float v) { key(k); return value1(v); }
+
+	size_t bytes() const { return _bytes; }
+
+private:
+	JsonWriter& open(const char* key, char c);
+	JsonWriter& close(char c);
+	void comma();
+	void put(char c) { _bytes += _out.write((uint8_t)c); }
+	void put(const char* s) { _bytes += _out.write((const uint8_t*)s, strlen(s)); }
+	void escaped(const char* s);
+
+	Print&   _out;
+	size_t   _bytes = 0;
+	uint32_t _hasItem = 0;		// bit d: level d already holds a member
+	uint8_t  _depth = 0;
+	bool     _afterKey = false;
+};
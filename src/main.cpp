@@ -3,45 +3,26 @@
 #include <Wire.h>
 #include <FS.h>
 #include "fs/fsCompat.h"
-#include <esp_heap_caps.h>
 
 #include <lvgl.h>
-#include <TFT_eSPI.h>
 
 #include <ADS1220_WE.h>
-#include <NS2009.h>
 
 #include "net/webPortal.h"
 #include "UI/ui.h"
 #include "UI/ui_Screen1.h"
 #include "UI/uiFacade.h"
+#include "UI/lvglDisplay.h"
+#include "UI/lvglTask.h"
 #include "UI/alertSystem.h"
+#include "UI/traceView.h"
+#include "UI/touchInput.h"
+#include "acq/adcAcquisition.h"
+#include "app/nutPipeline.h"
 
-// -------- ADS1220 pins (kept for completeness) --------
-#define ADS1220_CS_PIN		10
-#define ADS1220_DRDY_PIN	5
-
-ADS1220_WE ads(ADS1220_CS_PIN, ADS1220_DRDY_PIN);
-NS2009 ts;
-
-static lv_display_t* disp = nullptr;
-static uint32_t lvglLastTickMs = 0;
-
-static void lvglCreateDisplay() {
-	const uint16_t hor = 240;
-	const uint16_t ver = 320;
-	const uint32_t lines = 8;
-
-	lv_init();	// IMPORTANT
-
-	const size_t bufPixels = hor * lines;
-	lv_color_t* drawBuf = (lv_color_t*) heap_caps_malloc(bufPixels * sizeof(lv_color_t), MALLOC_CAP_DMA);
-	if (!drawBuf) drawBuf = (lv_color_t*) malloc(bufPixels * sizeof(lv_color_t));
-
-	disp = lv_tft_espi_create(hor, ver, drawBuf, bufPixels * sizeof(lv_color_t));
-	lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_0);
-	lv_display_set_default(disp);	// IMPORTANT
-}
+// -------- ADS1220 (pins and SPI host: acq/adcAcquisition.h) --------
+SPIClass adcSpi(ADS1220_SPI_HOST);
+ADS1220_WE ads(&adcSpi, ADS1220_CS_PIN, ADS1220_DRDY_PIN, false);	// bus started in setup() on its own pins
 
 void setup() {
 	Serial.begin(115200);
@@ -49,31 +30,25 @@ void setup() {
 
 	if (!fsBegin(true)) Serial.println("[MAIN] FS mount failed");
 
-	lvglCreateDisplay();
+	lvglDisplayCreate(240, 320);
 	ui_init();				// build the SquareLine UI on the default display
 
 	uiFacadeInit();
 	alertInit();
-	lvglLastTickMs = millis();
+	traceViewInit();
+	if (!touchInputBegin()) Serial.println("[MAIN] touch input not started");
 
 	webPortalBegin();
+	lvglTaskBegin();		// LVGL belongs to its task from here on; everything else posts
+
+	adcSpi.begin(ADS1220_SCK_PIN, ADS1220_MISO_PIN, ADS1220_MOSI_PIN, ADS1220_CS_PIN);
+	if (adcAcqBegin(ads, ADS1220_DRDY_PIN)) nutPipelineBegin();
+	else Serial.println("[MAIN] ADC acquisition not started");
 }
 
 void loop() {
-// Feed LVGL tick so lv_timer (blink timers, etc.) can run
-	uint32_t nowMs = millis();
-	uint32_t elapsed = nowMs - lvglLastTickMs;
-	if (elapsed > 0) {
-		lv_tick_inc(elapsed);
-		lvglLastTickMs = nowMs;
-	}
-
-
-	lv_timer_handler();
-
-	uiFacadePoll();		// apply posted UI changes on LVGL thread
-	alertPoll();
-
+	uiFacadePollCommits();	// operator picks from the Unknown prompt -> session
+	nutPipelinePoll();	// segmented nuts -> session (locks it against the HTTP task)
 	webPortalPoll();
 	delay(5);
 }
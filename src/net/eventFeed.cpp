@@ -0,0 +1,179 @@
+#include "eventFeed.h"
+#include "fs/jsonWriter.h"
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+static AsyncEventSource events("/api/events");
+
+/* ---- shared ring (any producer) ---- */
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+static FeedEvent ring[EVENT_FEED_RING];
+static uint32_t  head = 1;			// next sequence number; 0 is never used
+static uint32_t  published = 0;
+
+/* ---- subscribers (AsyncTCP task connects/disconnects, loop thread pumps) ---- */
+struct FeedClient {
+	AsyncEventSourceClient* client;
+	uint32_t cursor;				// next sequence to deliver
+	bool     needSync;
+	uint32_t dropped;
+};
+static SemaphoreHandle_t slotMutex = nullptr;
+static FeedClient slots[EVENT_FEED_MAX_CLIENTS];
+static uint32_t delivered = 0, dropped = 0, coalesced = 0;
+
+static const char* typeName(FeedEventType t) {
+	switch (t) {
+		case FeedEventType::Nut:		return "nut";
+		case FeedEventType::Reclass:	return "reclass";
+		case FeedEventType::Result:		return "result";
+		case FeedEventType::Session:	return "session";
+		case FeedEventType::LogError:	return "logerror";
+		default:						return "sync";
+	}
+}
+
+void eventFeedPublish(FeedEventType type, const ClassCounts& cc, NutClass cls, uint32_t nut, uint8_t confidence, bool passed) {
+	FeedEvent e = {};
+	e.type = type;
+	e.cls = cls;
+	e.nut = nut;
+	e.confidence = confidence;
+	e.passed = passed ? 1 : 0;
+	e.counts[0] = cc.api; e.counts[1] = cc.seconds; e.counts[2] = cc.rashi; e.counts[3] = cc.mangala;
+
+	portENTER_CRITICAL(&ringMux);
+	e.seq = head++;
+	ring[e.seq % EVENT_FEED_RING] = e;
+	published++;
+	portEXIT_CRITICAL(&ringMux);
+}
+
+// Copy event 'seq' out of the ring; false if it has been overwritten (or not written yet)
+static bool ringGet(uint32_t seq, FeedEvent& out) {
+	portENTER_CRITICAL(&ringMux);
+	out = ring[seq % EVENT_FEED_RING];
+	portEXIT_CRITICAL(&ringMux);
+	return out.seq == seq;
+}
+
+static size_t formatEvent(const FeedEvent& e, char* buf, size_t cap) {
+	const uint32_t tot = e.counts[0] + e.counts[1] + e.counts[2] + e.counts[3];
+	float pct[4] = {};
+	for (int i = 0; i < 4 && tot; ++i) pct[i] = 100.0f * e.counts[i] / tot;
+
+	BufferPrint out(buf, cap);
+	JsonWriter js(out);
+	js.beginObject().field("seq", e.seq);
+	switch (e.type) {
+		case FeedEventType::Nut:
+			js.field("nut", e.nut).field("class", SessionManager::className(e.cls)).field("conf", e.confidence);
+			break;
+		case FeedEventType::Reclass:
+			js.field("nut", e.nut).field("class", SessionManager::className(e.cls));
+			break;
+		case FeedEventType::Result:
+			js.field("passed", e.passed != 0);
+			break;
+		case FeedEventType::LogError:
+			js.field("dropped", e.nut);
+			break;
+		default: break;
+	}
+	js.beginObject("counts")
+	  .field("Api", e.counts[0]).field("Seconds", e.counts[1]).field("Rashi", e.counts[2]).field("Mangala", e.counts[3])
+	  .endObject();
+	js.beginObject("percents")
+	  .field1("Api", pct[0]).field1("Seconds", pct[1]).field1("Rashi", pct[2]).field1("Mangala", pct[3])
+	  .endObject();
+	js.endObject();
+	return out.length();
+}
+
+void eventFeedBegin(AsyncWebServer& server) {
+	slotMutex = xSemaphoreCreateMutex();
+
+	events.onConnect([](AsyncEventSourceClient* c) {
+		xSemaphoreTake(slotMutex, portMAX_DELAY);
+		FeedClient* s = nullptr;
+		for (FeedClient& f : slots) if (!f.client) { s = &f; break; }
+		if (s) {
+			portENTER_CRITICAL(&ringMux);
+			const uint32_t h = head;
+			portEXIT_CRITICAL(&ringMux);
+			const uint32_t last = c->lastId();
+			*s = FeedClient{ c, h, true, 0 };
+			if (last && last < h && h - (last + 1) <= EVENT_FEED_RING - 1) {	// Last-Event-ID still in the ring
+				s->cursor = last + 1;
+				s->needSync = false;
+			}
+		}
+		xSemaphoreGive(slotMutex);
+		if (!s) {
+			Serial.println("[SSE] client limit reached");
+			c->close();
+		}
+	});
+	events.onDisconnect([](AsyncEventSourceClient* c) {
+		xSemaphoreTake(slotMutex, portMAX_DELAY);
+		for (FeedClient& f : slots) if (f.client == c) f.client = nullptr;
+		xSemaphoreGive(slotMutex);
+	});
+	server.addHandler(&events);
+}
+
+void eventFeedPump() {
+	if (!slotMutex || xSemaphoreTake(slotMutex, 0) != pdTRUE) return;	// (dis)connect in progress
+
+	portENTER_CRITICAL(&ringMux);
+	const uint32_t h = head;
+	portEXIT_CRITICAL(&ringMux);
+
+	char buf[320];
+	FeedEvent e;
+	for (FeedClient& f : slots) {
+		if (!f.client) continue;
+
+		// lagging a whole ring (or just connected): replace the backlog with one snapshot
+		if (f.needSync || h - f.cursor > EVENT_FEED_RING - 1) {
+			if (f.client->packetsWaiting() >= EVENT_FEED_CLIENT_QUEUE) continue;
+			if (!f.needSync) {		// count the backlog once; needSync holds until a snapshot goes out
+				f.dropped += h - f.cursor;
+				dropped   += h - f.cursor;
+				coalesced++;
+				f.needSync = true;
+			}
+			if (h > 1) {
+				if (!ringGet(h - 1, e)) continue;	// overwritten since 'h' was read: retry next pump
+				e.type = FeedEventType::Sync;
+				formatEvent(e, buf, sizeof(buf));
+				if (!f.client->send(buf, "sync", h - 1)) continue;
+			}
+			f.cursor = h;
+			f.needSync = false;
+			continue;
+		}
+
+		while (f.cursor != h && f.client->packetsWaiting() < EVENT_FEED_CLIENT_QUEUE) {
+			if (!ringGet(f.cursor, e)) break;	// overwritten meanwhile; resync next pump
+			formatEvent(e, buf, sizeof(buf));
+			if (!f.client->send(buf, typeName(e.type), e.seq)) break;
+			f.cursor++;
+			delivered++;
+		}
+	}
+	xSemaphoreGive(slotMutex);
+}
+
+EventFeedStats eventFeedGetStats() {
+	EventFeedStats st = {};
+	st.published = published;
+	st.delivered = delivered;
+	st.dropped   = dropped;
+	st.coalesced = coalesced;
+	if (slotMutex && xSemaphoreTake(slotMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
+		for (const FeedClient& f : slots) if (f.client) st.clients++;
+		xSemaphoreGive(slotMutex);
+	}
+	return st;
+}
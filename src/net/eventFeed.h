@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include "app/sessionManager.h"
+
+class AsyncWebServer;
+
+/* Server-Sent Events feed: GET /api/events
+ *
+ * - Producers (HTTP task, loop thread) publish into one shared ring of the last
+ *   EVENT_FEED_RING events; publishing never waits on a client
+ * - Each subscriber has a cursor into the ring and at most EVENT_FEED_CLIENT_QUEUE
+ *   messages in flight; a client that falls a full ring behind loses the backlog and
+ *   gets one "sync" event with the latest counts instead (coalescing), and its drop
+ *   counter grows
+ * - Event ids are the ring sequence numbers, so a reconnecting browser (Last-Event-ID)
+ *   resumes where it left off if that is still in the ring
+ */
+
+#ifndef EVENT_FEED_RING
+#define EVENT_FEED_RING			32
+#endif
+#ifndef EVENT_FEED_MAX_CLIENTS
+#define EVENT_FEED_MAX_CLIENTS	4
+#endif
+#ifndef EVENT_FEED_CLIENT_QUEUE
+#define EVENT_FEED_CLIENT_QUEUE	4		// messages queued in AsyncTCP per client
+#endif
+
+enum class FeedEventType : uint8_t { Sync, Nut, Reclass, Result, Session, LogError };
+
+struct FeedEvent {
+	uint32_t      seq;			// filled by eventFeedPublish
+	FeedEventType type;
+	NutClass      cls;			// Nut / Reclass: class now in effect
+	uint8_t       confidence;	// Nut
+	uint8_t       passed;		// Result
+	uint32_t      nut;			// nut number (Nut / Reclass); LogError: records refused so far
+	uint32_t      counts[4];	// Api, Seconds, Rashi, Mangala after the event
+};
+
+struct EventFeedStats {
+	uint32_t published;
+	uint32_t delivered;
+	uint32_t dropped;			// events skipped for lagging clients
+	uint32_t coalesced;			// sync events sent in their place
+	uint8_t  clients;
+};
+
+void eventFeedBegin(AsyncWebServer& server);
+
+// Any thread. 'counts' are taken from 'cc'.
+void eventFeedPublish(FeedEventType type, const ClassCounts& cc, NutClass cls = NutClass::Unknown,
+	uint32_t nut = 0, uint8_t confidence = 0, bool passed = false);
+
+// Move ring events into client queues; call from loop()
+void eventFeedPump();
+
+EventFeedStats eventFeedGetStats();
@@ -0,0 +1,34 @@
+#include "httpLatency.h"
+#include <algorithm>
+
+static uint32_t ring[HTTP_LATENCY_WINDOW];
+static uint32_t scratch[HTTP_LATENCY_WINDOW];
+static uint32_t total = 0;
+
+void httpLatencyRecord(uint32_t us) {
+	ring[total % HTTP_LATENCY_WINDOW] = us;
+	total++;
+}
+
+void httpLatencyReset() {
+	total = 0;
+}
+
+HttpLatencyStats httpLatencyGetStats() {
+	HttpLatencyStats st = {};
+	st.requests = total;
+	st.window = total < HTTP_LATENCY_WINDOW ? total : HTTP_LATENCY_WINDOW;
+	if (st.window == 0) return st;
+
+	memcpy(scratch, ring, st.window * sizeof(uint32_t));
+	uint32_t* end = scratch + st.window;
+	auto pct = [&](uint32_t p) -> uint32_t {
+		uint32_t* nth = scratch + (st.window - 1) * p / 100;
+		std::nth_element(scratch, nth, end);
+		return *nth;
+	};
+	st.p50Us = pct(50);
+	st.p99Us = pct(99);
+	st.maxUs = *std::max_element(scratch, end);
+	return st;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+/* Handler latency recorder for the HTTP task
+ * - Keeps the last HTTP_LATENCY_WINDOW handler durations (µs) in a ring
+ * - Percentiles are computed on request (nth_element over a static copy)
+ * - Record and read from the HTTP task only; no locking
+ */
+
+#ifndef HTTP_LATENCY_WINDOW
+#define HTTP_LATENCY_WINDOW	256
+#endif
+
+struct HttpLatencyStats {
+	uint32_t requests;		// total recorded since boot/reset
+	uint32_t window;		// samples behind the percentiles
+	uint32_t p50Us;
+	uint32_t p99Us;
+	uint32_t maxUs;			// worst in the window
+};
+
+void httpLatencyRecord(uint32_t us);
+HttpLatencyStats httpLatencyGetStats();
+void httpLatencyReset();
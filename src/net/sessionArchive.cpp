@@ -0,0 +1,142 @@
+#include "sessionArchive.h"
+#include "fs/fsCompat.h"
+#include "fs/crc32.h"
+#include "app/sessionIndex.h"
+#include <algorithm>
+
+static const uint32_t TAR_BLOCK = 512;
+
+static inline uint32_t padded(uint32_t n) { return (n + TAR_BLOCK - 1) & ~(TAR_BLOCK - 1); }
+
+static bool endsWith(const char* s, const char* suffix) {
+	const size_t a = strlen(s), b = strlen(suffix);
+	return a >= b && strcmp(s + a - b, suffix) == 0;
+}
+
+bool SessionArchive::validId(const char* id) {
+	const size_t n = strlen(id);
+	if (n == 0 || n >= sizeof(((SessionIndexEntry*)nullptr)->id)) return false;
+	for (size_t i = 0; i < n; ++i) {
+		const char c = id[i];
+		if (!((c >= '0' && c <= '9') || c == '_' || c == '-')) return false;
+	}
+	return true;
+}
+
+bool SessionArchive::open(const char* id, uint32_t generation) {
+	close();
+	_count = 0;
+	_failed = false;
+	if (!validId(id)) return false;
+	strncpy(_id, id, sizeof(_id) - 1);
+
+	fs::File dir = FSYS.open(String("/sessions/") + id);
+	if (!dir || !dir.isDirectory()) return false;
+	for (fs::File f = dir.openNextFile(); f; f = dir.openNextFile()) {
+		if (f.isDirectory()) continue;
+		const char* name = f.name();
+		const char* slash = strrchr(name, '/');
+		if (slash) name = slash + 1;
+		// in-flight or superseded copies from atomicWriteFile come and go between requests
+		if (endsWith(name, ".tmp") || endsWith(name, ".bak")) continue;
+		if (strlen(name) >= sizeof(Entry::name) || _count == SESSION_ARCHIVE_MAX_FILES) {
+			Serial.printf("[ARCHIVE] skipping %s\n", name);
+			continue;
+		}
+		Entry& e = _e[_count++];
+		memset(&e, 0, sizeof(e));
+		strcpy(e.name, name);
+		e.size = f.size();
+	}
+	dir.close();
+
+	// stable layout: Range requests depend on offsets being the same next time
+	std::sort(_e, _e + _count, [](const Entry& a, const Entry& b) { return strcmp(a.name, b.name) < 0; });
+
+	// sizes catch appends; overrides are patched in place and only show in the generation
+	uint32_t off = 0, tag = crc32Update(0, &generation, sizeof(generation));
+	for (uint8_t i = 0; i < _count; ++i) {
+		_e[i].start = off;
+		off += TAR_BLOCK + padded(_e[i].size);
+		tag = crc32Update(tag, &_e[i], sizeof(Entry));
+	}
+	_total = off + 2 * TAR_BLOCK;	// end-of-archive marker
+	_etag  = tag;
+	_mtime = SessionIndex::idToEpoch(id);
+	return true;
+}
+
+void SessionArchive::close() {
+	if (_f) _f.close();
+	_fIdx = -1;
+}
+
+// POSIX ustar header for "<id>/<name>"
+void SessionArchive::header(const Entry& e, uint8_t out[512]) const {
+	memset(out, 0, TAR_BLOCK);
+	char* h = (char*)out;
+	snprintf(h, 100, "%s/%s", _id, e.name);
+	memcpy(h + 100, "0000644", 8);			// mode
+	memcpy(h + 108, "0000000", 8);			// uid
+	memcpy(h + 116, "0000000", 8);			// gid
+	snprintf(h + 124, 12, "%011o", (unsigned)e.size);
+	snprintf(h + 136, 12, "%011o", (unsigned)_mtime);
+	h[156] = '0';							// regular file
+	memcpy(h + 257, "ustar", 6);
+	memcpy(h + 263, "00", 2);
+
+	memset(h + 148, ' ', 8);				// checksum is computed over spaces here
+	uint32_t sum = 0;
+	for (uint32_t i = 0; i < TAR_BLOCK; ++i) sum += out[i];
+	snprintf(h + 148, 8, "%06o", (unsigned)sum);
+	h[155] = ' ';
+}
+
+size_t SessionArchive::readData(uint8_t idx, uint32_t pos, uint8_t* buf, size_t len) {
+	if (_fIdx != idx) {
+		close();
+		_f = FSYS.open(String("/sessions/") + _id + "/" + _e[idx].name, "r");
+		if (!_f) return 0;
+		_fIdx = idx;
+	}
+	if (_f.position() != pos && !_f.seek(pos)) return 0;
+	return _f.read(buf, len);
+}
+
+size_t SessionArchive::read(uint32_t offset, uint8_t* buf, size_t len) {
+	size_t done = 0;
+	while (done < len && offset < _total) {
+		// locate the entry holding 'offset' (at most SESSION_ARCHIVE_MAX_FILES)
+		uint8_t i = 0;
+		while (i < _count && offset >= _e[i].start + TAR_BLOCK + padded(_e[i].size)) ++i;
+
+		size_t n;
+		if (i == _count) {							// trailing zero blocks
+			n = std::min<size_t>(len - done, _total - offset);
+			memset(buf + done, 0, n);
+		} else {
+			const Entry& e = _e[i];
+			const uint32_t rel = offset - e.start;
+			if (rel < TAR_BLOCK) {					// header
+				uint8_t hdr[TAR_BLOCK];
+				header(e, hdr);
+				n = std::min<size_t>(len - done, TAR_BLOCK - rel);
+				memcpy(buf + done, hdr + rel, n);
+			} else if (rel - TAR_BLOCK < e.size) {	// file data
+				const uint32_t pos = rel - TAR_BLOCK;
+				n = readData(i, pos, buf + done, std::min<size_t>(len - done, e.size - pos));
+				if (n == 0) {		// shorter than its snapshot: the archive cannot be completed
+					Serial.printf("[ARCHIVE] read failed: %s @%u\n", e.name, (unsigned)pos);
+					_failed = true;
+					break;
+				}
+			} else {								// padding to the block boundary
+				n = std::min<size_t>(len - done, TAR_BLOCK + padded(e.size) - rel);
+				memset(buf + done, 0, n);
+			}
+		}
+		done += n;
+		offset += n;
+	}
+	return done;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+
+/* Read-only tar view of one session folder, produced on the fly
+ *
+ *   [ustar header 512][file data, zero-padded to 512] x files  [zero block x 2]
+ *
+ * - open() snapshots the file list (sorted, .tmp/.bak skipped) and sizes, so every
+ *   archive offset maps to a fixed (file, position); read(offset) can start anywhere,
+ *   which is what HTTP Range resume needs
+ * - Headers are synthesized per call and file data is read through one open handle:
+ *   RAM use does not depend on the session size
+ * - Bytes appended to a file after open() are not included (the size is the snapshot)
+ * - A file that reads short of its snapshot size sets failed(): the archive cannot be
+ *   completed, and the caller must abort the transfer rather than end it cleanly
+ */
+
+#ifndef SESSION_ARCHIVE_MAX_FILES
+#define SESSION_ARCHIVE_MAX_FILES	8
+#endif
+
+class SessionArchive {
+public:
+	// 'id' is the folder name under /sessions; rejects anything that is not [0-9_-].
+	// 'generation' counts in-place edits (SessionManager::logEdits) and goes into the ETag.
+	bool open(const char* id, uint32_t generation = 0);
+	void close();
+
+	uint32_t size() const { return _total; }
+	uint32_t etag() const { return _etag; }		// changes with any file's size or the generation
+	bool     failed() const { return _failed; }
+	uint8_t  files() const { return _count; }
+
+	// Copy up to 'len' archive bytes starting at 'offset'; returns bytes copied (0 at end)
+	size_t read(uint32_t offset, uint8_t* buf, size_t len);
+
+	static bool validId(const char* id);
+
+private:
+	struct Entry {
+		char     name[24];
+		uint32_t size;
+		uint32_t start;		// archive offset of the header block
+	};
+
+	void header(const Entry& e, uint8_t out[512]) const;
+	size_t readData(uint8_t idx, uint32_t pos, uint8_t* buf, size_t len);
+
+	char     _id[24] = {};
+	uint32_t _mtime = 0;
+	Entry    _e[SESSION_ARCHIVE_MAX_FILES];
+	uint8_t  _count = 0;
+	uint32_t _total = 0;
+	uint32_t _etag = 0;
+	bool     _failed = false;
+
+	fs::File _f;
+	int8_t   _fIdx = -1;		// which entry _f has open
+};
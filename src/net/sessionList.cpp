@@ -0,0 +1,126 @@
+#include "sessionList.h"
+#include "fs/jsonWriter.h"
+
+static const char* stateName(uint8_t s)  { return s == SESSION_STATE_OPEN ? "open" : "closed"; }
+static const char* resultName(uint8_t r) {
+	switch (r) {
+		case SESSION_RESULT_PASS: return "pass";
+		case SESSION_RESULT_FAIL: return "fail";
+		default:                  return "none";
+	}
+}
+
+bool SessionListStream::parseStatus(const char* s, SessionStatusFilter& out) {
+	if      (!strcmp(s, "any"))    out = SessionStatusFilter::Any;
+	else if (!strcmp(s, "open"))   out = SessionStatusFilter::Open;
+	else if (!strcmp(s, "closed")) out = SessionStatusFilter::Closed;
+	else if (!strcmp(s, "pass"))   out = SessionStatusFilter::Pass;
+	else if (!strcmp(s, "fail"))   out = SessionStatusFilter::Fail;
+	else return false;
+	return true;
+}
+
+bool SessionListStream::begin(const SessionQuery& q) {
+	_q = q;
+	if (_q.limit > SESSION_LIST_MAX_LIMIT) _q.limit = SESSION_LIST_MAX_LIMIT;
+	_skipped = _emitted = 0;
+	_phase = 0;
+	_batchLen = _batchPos = 0;
+	_pendLen = _pendPos = 0;
+	// Runs on the web task without the session lock: read-only, so a pending roll-forward
+	// is applied in RAM and left for the owner to persist
+	if (!_index.begin(true)) return false;
+	_slot = _q.from ? (uint32_t)_index.lowerBound(_q.from) : 0;
+	if (_q.status == SessionStatusFilter::Any) {	// every entry matches: page by seeking
+		_slot += _q.offset;
+		_skipped = _q.offset;
+	}
+	return true;
+}
+
+bool SessionListStream::nextMatch(SessionIndexEntry& e) {
+	for (;;) {
+		if (_batchPos == _batchLen) {
+			if (_slot >= _index.count()) return false;
+			_batchLen = (uint8_t)_index.readMany((int32_t)_slot, _batch, SESSION_LIST_BATCH);
+			_batchPos = 0;
+			if (_batchLen == 0) return false;
+			_slot += _batchLen;
+		}
+		const SessionIndexEntry& c = _batch[_batchPos++];
+		if (c.state == 0) continue;						// corrupt entry
+		if (c.startEpoch > _q.to) { _slot = _index.count(); _batchLen = _batchPos; return false; }	// time-ordered: done
+		if (c.startEpoch < _q.from) continue;
+		bool ok = true;
+		switch (_q.status) {
+			case SessionStatusFilter::Open:   ok = c.state == SESSION_STATE_OPEN; break;
+			case SessionStatusFilter::Closed: ok = c.state == SESSION_STATE_CLOSED; break;
+			case SessionStatusFilter::Pass:   ok = c.result == SESSION_RESULT_PASS; break;
+			case SessionStatusFilter::Fail:   ok = c.result == SESSION_RESULT_FAIL; break;
+			default: break;
+		}
+		if (!ok) continue;
+		if (_skipped < _q.offset) { _skipped++; continue; }
+		e = c;
+		return true;
+	}
+}
+
+void SessionListStream::renderHead() {
+	BufferPrint out(_pend, sizeof(_pend));
+	JsonWriter(out).beginObject()
+		.field("count", _index.count()).field("offset", _q.offset).field("limit", _q.limit)
+		.beginArray("sessions");
+	_pendLen = out.length(); _pendPos = 0;
+}
+
+void SessionListStream::render(const SessionIndexEntry& e) {
+	BufferPrint out(_pend, sizeof(_pend));
+	if (_emitted) out.write(',');
+	JsonWriter js(out);
+	js.beginObject()
+	  .field("id", e.id)
+	  .field("start", e.startEpoch)
+	  .field("state", stateName(e.state))
+	  .field("result", resultName(e.result))
+	  .field("nuts", e.last)
+	  .beginObject("counts")
+	  .field("Api", e.counts[0]).field("Seconds", e.counts[1]).field("Rashi", e.counts[2]).field("Mangala", e.counts[3])
+	  .endObject()
+	  .endObject();
+	_pendLen = out.length(); _pendPos = 0;
+}
+
+void SessionListStream::renderTail() {
+	// one look-ahead tells the client whether another page exists
+	SessionIndexEntry e;
+	const bool more = nextMatch(e);
+	BufferPrint out(_pend, sizeof(_pend));
+	out.print("],\"more\":");
+	out.print(more ? "true" : "false");
+	out.write('}');
+	_pendLen = out.length(); _pendPos = 0;
+}
+
+size_t SessionListStream::read(uint8_t* buf, size_t len) {
+	size_t done = 0;
+	while (done < len) {
+		if (_pendPos < _pendLen) {
+			const size_t n = (_pendLen - _pendPos) < (len - done) ? (_pendLen - _pendPos) : (len - done);
+			memcpy(buf + done, _pend + _pendPos, n);
+			_pendPos += n; done += n;
+			continue;
+		}
+		SessionIndexEntry e;
+		switch (_phase) {
+			case 0: renderHead(); _phase = 1; break;
+			case 1:
+				if (_emitted < _q.limit && nextMatch(e)) { render(e); _emitted++; }
+				else { renderTail(); _phase = 2; }
+				break;
+			case 2: _phase = 3; break;
+			default: return done;
+		}
+	}
+	return done;
+}
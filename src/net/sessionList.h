@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "app/sessionIndex.h"
+
+/* Paginated session listing served straight from /sessions/index.bin
+ *
+ *   {"count":N,"offset":o,"limit":l,"sessions":[{...},...],"more":bool}
+ *
+ * - Entries are read SESSION_LIST_BATCH at a time and rendered one at a time into a
+ *   small staging buffer; the full list is never in RAM
+ * - 'from' seeks with a binary search, 'to' ends the scan, and without a status filter
+ *   'offset' is a direct seek: the cost is limit entries, not the sessions on flash
+ *   (a status filter has to look at the entries it skips)
+ * - Order is the index order (oldest first)
+ * - 'from'/'to' compare against the time in the session id. Sessions started before
+ *   anything set the clock carry sequence stamps instead (see SessionManager::setClock)
+ */
+
+#ifndef SESSION_LIST_BATCH
+#define SESSION_LIST_BATCH		8
+#endif
+#ifndef SESSION_LIST_MAX_LIMIT
+#define SESSION_LIST_MAX_LIMIT	200
+#endif
+
+enum class SessionStatusFilter : uint8_t { Any, Open, Closed, Pass, Fail };
+
+struct SessionQuery {
+	uint32_t offset = 0;		// matching sessions to skip
+	uint32_t limit = 50;
+	uint32_t from = 0;			// startEpoch >= from
+	uint32_t to = UINT32_MAX;	// startEpoch <= to
+	SessionStatusFilter status = SessionStatusFilter::Any;
+};
+
+class SessionListStream {
+public:
+	// Loads the index header; false if there is no usable index
+	bool begin(const SessionQuery& q);
+	// Next bytes of the JSON document; 0 once it is complete
+	size_t read(uint8_t* buf, size_t len);
+
+	static bool parseStatus(const char* s, SessionStatusFilter& out);
+
+private:
+	bool nextMatch(SessionIndexEntry& e);
+	void render(const SessionIndexEntry& e);
+	void renderHead();
+	void renderTail();
+
+	SessionIndex _index;
+	SessionQuery _q;
+	uint32_t _slot = 0;		// next slot to examine
+	uint32_t _skipped = 0;
+	uint32_t _emitted = 0;
+	uint8_t  _phase = 0;		// 0 head, 1 entries, 2 tail, 3 done
+
+	SessionIndexEntry _batch[SESSION_LIST_BATCH];
+	uint8_t _batchLen = 0, _batchPos = 0;
+
+	char   _pend[256];		// one rendered piece
+	size_t _pendLen = 0, _pendPos = 0;
+};
@@ -0,0 +1,266 @@
+#include "simBulk.h"
+#include "app/sessionLog.h"
+#include "dsp/nutSegmenter.h"
+#include "fs/jsonWriter.h"
+#include "net/eventFeed.h"
+#include "UI/uiFacade.h"
+#include "UI/alertSystem.h"
+#include <algorithm>
+
+enum class SimState : uint8_t { Idle, Queued, Running, Done, Cancelled, Error };
+
+struct SimReport {
+	SimState state;
+	uint32_t requested, done, failed;
+	uint32_t targetRate;
+	uint32_t elapsedUs;
+	uint32_t p50Us, p99Us, maxUs, meanUs;
+	uint32_t uiCoalesced, uiDropped, alertDropped, sseDropped;
+	char     mode[8];
+	char     err[32];
+};
+
+static SimNutFn sink = nullptr;
+
+// shared with the HTTP task
+static portMUX_TYPE simMux = portMUX_INITIALIZER_UNLOCKED;
+static SimBulkConfig pendingCfg;
+static bool      startPending = false, cancelPending = false;
+static SimReport report = {};
+
+// loop thread only
+static SimBulkConfig cfg;
+static uint32_t t0Us = 0;
+static uint32_t rng = 1;
+static uint64_t latSum = 0;
+static uint32_t latMax = 0;
+static uint32_t lat[SIM_BULK_LAT_SAMPLES];
+static UiFacadeStats  ui0;
+static AlertStats     alert0;
+static EventFeedStats sse0;
+static SessionLogReader replay;
+static bool      replaying = false;
+static NutWindow replayWin;
+static int16_t   replaySamples[NUT_WINDOW_MAX];
+
+static const char* stateName(SimState s) {
+	switch (s) {
+		case SimState::Queued:    return "queued";
+		case SimState::Running:   return "running";
+		case SimState::Done:      return "done";
+		case SimState::Cancelled: return "cancelled";
+		case SimState::Error:     return "error";
+		default:                  return "idle";
+	}
+}
+
+bool simBulkParseDist(const char* s, uint16_t weight[5]) {
+	static const char* names[5] = { "Api", "Seconds", "Rashi", "Mangala", "Unknown" };
+	uint16_t w[5] = {};
+	while (*s) {
+		const char* colon = strchr(s, ':');
+		if (!colon) return false;
+		int k = -1;
+		for (int i = 0; i < 5; ++i)
+			if ((size_t)(colon - s) == strlen(names[i]) && strncasecmp(s, names[i], colon - s) == 0) k = i;
+		if (k < 0) return false;
+		char* end = nullptr;
+		const unsigned long v = strtoul(colon + 1, &end, 10);
+		if (end == colon + 1 || v > 10000) return false;
+		w[k] = (uint16_t)v;
+		s = end;
+		if (*s == ',') ++s;
+		else if (*s) return false;
+	}
+	uint32_t tot = 0;
+	for (int i = 0; i < 5; ++i) tot += w[i];
+	if (tot == 0) return false;
+	memcpy(weight, w, sizeof(w));
+	return true;
+}
+
+void simBulkBegin(SimNutFn fn) {
+	sink = fn;
+}
+
+bool simBulkStart(const SimBulkConfig& c) {
+	bool ok = false;
+	portENTER_CRITICAL(&simMux);
+	if (!startPending && report.state != SimState::Running) {
+		pendingCfg = c;
+		startPending = true;
+		report = SimReport{};
+		report.state = SimState::Queued;
+		report.requested = c.count == UINT32_MAX ? 0 : c.count;
+		report.targetRate = c.ratePerSec;
+		ok = true;
+	}
+	portEXIT_CRITICAL(&simMux);
+	return ok;
+}
+
+void simBulkCancel() {
+	portENTER_CRITICAL(&simMux);
+	cancelPending = true;
+	portEXIT_CRITICAL(&simMux);
+}
+
+static inline uint32_t xorshift() {
+	rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+	return rng;
+}
+
+static NutClass drawClass() {
+	uint32_t tot = 0;
+	for (int i = 0; i < 5; ++i) tot += cfg.weight[i];
+	uint32_t r = xorshift() % tot;
+	for (int i = 0; i < 4; ++i) {
+		if (r < cfg.weight[i]) return (NutClass)i;
+		r -= cfg.weight[i];
+	}
+	return NutClass::Unknown;
+}
+
+// Next stored nut, rebuilt into ADC codes; false at the end of the log
+static bool nextReplay(NutClass& cls) {
+	NutRecordHeader h;
+	if (!replay.next(h, replaySamples, NUT_WINDOW_MAX)) return false;
+	NutWindow& w = replayWin;
+	w.count      = h.sampleCount < NUT_WINDOW_MAX ? h.sampleCount : NUT_WINDOW_MAX;
+	w.baseline   = h.baseline;
+	w.tStartUs   = h.tStartUs;
+	w.tEndUs     = h.tStartUs + (uint32_t)h.periodUs * (w.count ? w.count - 1u : 0u);
+	w.triggerIdx = h.triggerIdx;
+	w.truncated  = (h.flags & NUT_REC_TRUNCATED) != 0;
+	for (uint16_t i = 0; i < w.count; ++i) w.samples[i] = ((int32_t)replaySamples[i] << h.sampleShift) + h.baseline;
+	cls = (NutClass)(h.overrideClass != NUT_OVERRIDE_NONE ? h.overrideClass : h.predClass);
+	return true;
+}
+
+static void finish(SimState st, const char* err = nullptr) {
+	if (replaying) { replay.close(); replaying = false; }
+
+	const uint32_t n = report.done < SIM_BULK_LAT_SAMPLES ? report.done : SIM_BULK_LAT_SAMPLES;
+	uint32_t p50 = 0, p99 = 0;
+	if (n) {
+		std::nth_element(lat, lat + (n - 1) / 2, lat + n);       p50 = lat[(n - 1) / 2];
+		std::nth_element(lat, lat + (n - 1) * 99 / 100, lat + n); p99 = lat[(n - 1) * 99 / 100];
+	}
+	const UiFacadeStats  ui = uiFacadeGetStats();
+	const AlertStats     al = alertGetStats();
+	const EventFeedStats ev = eventFeedGetStats();
+
+	portENTER_CRITICAL(&simMux);
+	report.state        = st;
+	report.elapsedUs    = micros() - t0Us;
+	report.p50Us        = p50;
+	report.p99Us        = p99;
+	report.meanUs       = report.done ? (uint32_t)(latSum / report.done) : 0;
+	report.uiCoalesced  = ui.coalesced - ui0.coalesced;
+	report.uiDropped    = ui.dropped - ui0.dropped;
+	report.alertDropped = al.dropped - alert0.dropped;
+	report.sseDropped   = ev.dropped - sse0.dropped;
+	if (err) strncpy(report.err, err, sizeof(report.err) - 1);
+	portEXIT_CRITICAL(&simMux);
+	Serial.printf("[SIM] bulk %s: %u nuts in %u ms\n", stateName(st), (unsigned)report.done, (unsigned)(report.elapsedUs / 1000));
+}
+
+static void startJob() {
+	latSum = 0;
+	latMax = 0;
+	rng = cfg.seed ? cfg.seed : 1;
+	ui0 = uiFacadeGetStats();
+	alert0 = alertGetStats();
+	sse0 = eventFeedGetStats();
+	t0Us = micros();
+
+	portENTER_CRITICAL(&simMux);
+	report.state = SimState::Running;
+	strcpy(report.mode, cfg.replayId[0] ? "replay" : "dist");
+	portEXIT_CRITICAL(&simMux);
+
+	if (cfg.replayId[0]) {
+		replaying = replay.open(String("/sessions/") + cfg.replayId + "/nuts.bin");
+		if (!replaying) finish(SimState::Error, "replay log not found");
+	}
+}
+
+void simBulkPoll() {
+	bool start = false, cancel = false;
+	portENTER_CRITICAL(&simMux);
+	if (startPending) { cfg = pendingCfg; startPending = false; start = true; }
+	cancel = cancelPending; cancelPending = false;
+	const bool running = report.state == SimState::Running || start;
+	portEXIT_CRITICAL(&simMux);
+
+	if (!running || !sink) return;
+	if (start) {
+		startJob();
+		if (report.state != SimState::Running) return;
+	}
+	if (cancel) { finish(SimState::Cancelled); return; }
+
+	// pace against the wall clock; catch up at most SIM_BULK_PER_POLL per pass
+	const uint32_t elapsed = micros() - t0Us;
+	uint32_t due = cfg.count;
+	if (cfg.ratePerSec) {
+		const uint64_t d = (uint64_t)elapsed * cfg.ratePerSec / 1000000u + 1;
+		if (d < due) due = (uint32_t)d;
+	}
+
+	uint32_t done = report.done, failed = report.failed;
+	for (uint8_t k = 0; k < SIM_BULK_PER_POLL && done < due; ++k) {
+		NutClass cls;
+		const NutWindow* w = nullptr;
+		if (replaying) {
+			if (!nextReplay(cls)) { due = done; cfg.count = done; break; }
+			w = &replayWin;
+		} else {
+			cls = drawClass();
+		}
+		const uint32_t t = micros();
+		const bool ok = sink(cls, w);
+		const uint32_t dt = micros() - t;
+		if (!ok) failed++;
+		lat[done % SIM_BULK_LAT_SAMPLES] = dt;
+		latSum += dt;
+		if (dt > latMax) latMax = dt;
+		done++;
+	}
+
+	portENTER_CRITICAL(&simMux);
+	report.done = done;
+	report.failed = failed;
+	report.maxUs = latMax;
+	report.requested = cfg.count == UINT32_MAX ? 0 : cfg.count;	// 0: replay until the log ends
+	report.elapsedUs = micros() - t0Us;
+	portEXIT_CRITICAL(&simMux);
+
+	if (done >= cfg.count) finish(SimState::Done);
+}
+
+void simBulkWriteReport(JsonWriter& js) {
+	portENTER_CRITICAL(&simMux);
+	const SimReport r = report;
+	portEXIT_CRITICAL(&simMux);
+
+	const float secs = r.elapsedUs / 1e6f;
+	js.beginObject()
+	  .field("state", stateName(r.state))
+	  .field("mode", r.mode)
+	  .field("requested", r.requested)
+	  .field("done", r.done)
+	  .field("failed", r.failed)
+	  .field("targetRate", r.targetRate)
+	  .field("elapsedMs", r.elapsedUs / 1000)
+	  .field1("nps", secs > 0 ? r.done / secs : 0.0f);
+	js.beginObject("latencyUs")
+	  .field("p50", r.p50Us).field("p99", r.p99Us).field("mean", r.meanUs).field("max", r.maxUs)
+	  .endObject();
+	js.beginObject("dropped")
+	  .field("ui", r.uiDropped).field("alert", r.alertDropped).field("sse", r.sseDropped)
+	  .endObject();
+	js.field("uiCoalesced", r.uiCoalesced);
+	if (r.err[0]) js.field("error", r.err);
+	js.endObject();
+}
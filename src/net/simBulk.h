@@ -0,0 +1,46 @@
+#pragma once
+#include <Arduino.h>
+#include "app/nutClass.h"
+
+struct NutWindow;
+class JsonWriter;
+
+/* Bulk simulation / replay for throughput regression runs
+ *
+ * - A job feeds 'count' nuts through the same sink as the ADC pipeline (session log,
+ *   counts, UI/alert posting, SSE) at 'ratePerSec' (0 = as fast as the loop allows)
+ * - Classes are drawn from a weight table, or replayed with their stored traces from
+ *   an earlier session's nuts.bin
+ * - Runs on the loop thread, at most SIM_BULK_PER_POLL nuts per loop pass so LVGL
+ *   keeps its cadence; start/cancel/report are safe from the HTTP task
+ * - The report has achieved nuts/s, per-nut sink latency (p50/p99 once the job ends,
+ *   mean/max live) and how many UI percentage updates / alert flashes / SSE events
+ *   were dropped during the run
+ */
+
+#ifndef SIM_BULK_PER_POLL
+#define SIM_BULK_PER_POLL		16
+#endif
+#ifndef SIM_BULK_LAT_SAMPLES
+#define SIM_BULK_LAT_SAMPLES	1024	// latest per-nut latencies kept for percentiles
+#endif
+
+// Record one nut (w == nullptr: synthetic trace). Called on the loop thread.
+typedef bool (*SimNutFn)(NutClass cls, const NutWindow* w);
+
+struct SimBulkConfig {
+	uint32_t count = 100;
+	uint32_t ratePerSec = 0;
+	uint16_t weight[5] = { 1, 1, 1, 1, 0 };	// Api, Seconds, Rashi, Mangala, Unknown
+	uint32_t seed = 1;
+	char     replayId[24] = {};				// session folder to replay instead of weights
+};
+
+// "Api:40,Seconds:5,Rashi:50,Mangala:5[,Unknown:n]" -> weights
+bool simBulkParseDist(const char* s, uint16_t weight[5]);
+
+void simBulkBegin(SimNutFn fn);
+bool simBulkStart(const SimBulkConfig& cfg);	// false if a job is already queued/running
+void simBulkCancel();
+void simBulkPoll();								// loop thread
+void simBulkWriteReport(JsonWriter& js);		// any thread
@@ -0,0 +1,58 @@
+#pragma once
+// GENERATED by tools/embed_web.py from web/ -- do not edit
+#include <Arduino.h>
+
+struct WebAsset {
+	const char*    path;
+	const char*    type;
+	const char*    etag;		// strong, quoted
+	const uint8_t* gz;
+	uint32_t       gzLen;
+};
+
+// index.html: 1447 -> 609 bytes
+static const uint8_t web_index_html_gz[] PROGMEM = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x54, 0xc1, 0x6e, 0xdb, 0x30,
+	0x0c, 0x3d, 0xd7, 0x5f, 0xa1, 0x9d, 0x94, 0xa2, 0x49, 0xbc, 0xf4, 0x30, 0x0c, 0x89, 0xed, 0xa1,
+	0x2b, 0x02, 0x6c, 0x40, 0x77, 0x59, 0xb0, 0xd3, 0xb0, 0x03, 0x6b, 0xd1, 0xb1, 0x30, 0x59, 0x36,
+	0x24, 0x3a, 0x89, 0x11, 0xf4, 0xdf, 0x47, 0xd9, 0xce, 0x9a, 0x0e, 0xdd, 0x80, 0xb5, 0x08, 0x1c,
+	0x8a, 0x4f, 0xd4, 0xd3, 0x23, 0x69, 0x33, 0x79, 0xa3, 0xea, 0x9c, 0xba, 0x06, 0x45, 0x49, 0x95,
+	0xc9, 0xa2, 0xe4, 0x64, 0x10, 0x14, 0x9b, 0x0a, 0x09, 0x84, 0x85, 0x0a, 0x53, 0xb9, 0xd3, 0xb8,
+	0x6f, 0x6a, 0x47, 0x52, 0xe4, 0xb5, 0x25, 0xb4, 0x94, 0xca, 0xbd, 0x56, 0x54, 0xa6, 0x0a, 0x77,
+	0x3a, 0xc7, 0x59, 0xef, 0x4c, 0xb5, 0xd5, 0xa4, 0xc1, 0xcc, 0x7c, 0x0e, 0x06, 0xd3, 0x85, 0x64,
+	0x0e, 0xd2, 0x64, 0x30, 0xbb, 0x71, 0x98, 0x83, 0xb8, 0x35, 0xe0, 0xbd, 0x2e, 0x34, 0xba, 0x24,
+	0x1e, 0xf0, 0x28, 0xf1, 0xd4, 0x05, 0x7b, 0x5f, 0xab, 0xee, 0x58, 0x30, 0xf5, 0xac, 0x80, 0x4a,
+	0x9b, 0x6e, 0xe9, 0x3b, 0x4f, 0x58, 0xcd, 0x5a, 0x3d, 0xbd, 0x71, 0x4c, 0xb9, 0xaa, 0xc0, 0x6d,
+	0xb5, 0x5d, 0x2e, 0xde, 0x35, 0x87, 0x87, 0x68, 0xee, 0xea, 0xfd, 0x51, 0x69, 0xdf, 0x18, 0xe8,
+	0x96, 0x85, 0xc1, 0xc3, 0x6a, 0x0b, 0xcd, 0xf2, 0x7d, 0x73, 0x58, 0x05, 0x67, 0xb6, 0x77, 0xec,
+	0x85, 0xbf, 0xd3, 0x29, 0xde, 0x11, 0x6f, 0x1f, 0xa2, 0xfb, 0x96, 0xa8, 0xb6, 0xc7, 0x06, 0x94,
+	0xd2, 0x76, 0xdb, 0xa3, 0x8b, 0xeb, 0xc0, 0x97, 0xc4, 0xa3, 0x8c, 0x24, 0x1e, 0x53, 0x0f, 0x7a,
+	0x42, 0x21, 0x16, 0xcf, 0x48, 0x67, 0x30, 0xe2, 0xad, 0xeb, 0x6c, 0x83, 0x8c, 0xd5, 0x96, 0x91,
+	0x6b, 0x8e, 0x55, 0x7a, 0x27, 0xf2, 0x10, 0x96, 0x4a, 0x96, 0x17, 0x72, 0x2f, 0x6a, 0x57, 0x09,
+	0x2e, 0x62, 0x59, 0xab, 0x54, 0x36, 0xb5, 0xe7, 0xea, 0x41, 0x4e, 0x7c, 0x22, 0x95, 0x31, 0x34,
+	0x3a, 0xf6, 0xc3, 0x79, 0xbe, 0x1c, 0xb8, 0xb2, 0x59, 0x32, 0xe8, 0xcb, 0x36, 0xc1, 0x15, 0xbf,
+	0xc9, 0x47, 0x34, 0x89, 0x03, 0xdd, 0x7f, 0xb0, 0xa2, 0x55, 0x8f, 0x9c, 0x6b, 0xab, 0xfe, 0xce,
+	0x18, 0xb3, 0xf4, 0x53, 0x4a, 0xba, 0x6a, 0x0d, 0x10, 0xbe, 0x3c, 0xa7, 0x91, 0xe0, 0xc3, 0x70,
+	0xec, 0xa6, 0xd1, 0x8f, 0x22, 0xae, 0x04, 0xbb, 0x2f, 0x48, 0xe8, 0x29, 0xe5, 0x06, 0xf9, 0x15,
+	0x54, 0xfe, 0x9c, 0x76, 0x84, 0x5e, 0x4d, 0xfd, 0x15, 0x7c, 0xf9, 0x44, 0x6f, 0x0f, 0xbc, 0x9a,
+	0xf6, 0x0b, 0xd8, 0x2d, 0x18, 0x38, 0x27, 0x1e, 0xa1, 0x57, 0x53, 0x7f, 0xb3, 0x3f, 0x6d, 0xbd,
+	0xb7, 0xe7, 0xd4, 0x23, 0xf4, 0xcf, 0x36, 0xdf, 0xe9, 0xdd, 0xa9, 0xc5, 0x8d, 0x43, 0xa1, 0xf9,
+	0x2e, 0xc3, 0x90, 0xcc, 0x66, 0x49, 0xcc, 0xc0, 0xb3, 0x9d, 0x07, 0x51, 0x3a, 0x2c, 0x58, 0x06,
+	0x7f, 0x22, 0x86, 0x4a, 0x99, 0x7d, 0xea, 0x6d, 0x12, 0xc3, 0xf9, 0xe6, 0x1f, 0xef, 0x35, 0xb5,
+	0xdc, 0xa8, 0x4d, 0x6f, 0x9f, 0x09, 0x2c, 0x89, 0x9a, 0x38, 0x64, 0x63, 0xf3, 0x4e, 0x66, 0x77,
+	0xc3, 0x62, 0x88, 0x3b, 0x89, 0xf5, 0xb9, 0xd3, 0x0d, 0x65, 0xd1, 0x0e, 0x9c, 0x40, 0x2f, 0x52,
+	0x61, 0x71, 0x2f, 0xd6, 0x3b, 0x9e, 0x40, 0x9b, 0xba, 0x75, 0x39, 0x4e, 0x06, 0x26, 0x0c, 0x88,
+	0x97, 0x97, 0xab, 0xe8, 0xbb, 0xf4, 0x9d, 0xcd, 0xe5, 0x54, 0xc8, 0x51, 0x46, 0x58, 0xda, 0x96,
+	0x82, 0xe1, 0x4f, 0x39, 0xa4, 0x34, 0x2c, 0x7d, 0x6b, 0x48, 0xfe, 0x98, 0x73, 0x71, 0xd6, 0x90,
+	0x97, 0x93, 0xa2, 0xb5, 0x7d, 0x9d, 0xc5, 0x84, 0x2e, 0xc5, 0x31, 0xba, 0x40, 0x3f, 0xe7, 0x39,
+	0xd1, 0xdf, 0x74, 0xa7, 0x79, 0x16, 0x59, 0x74, 0x13, 0x9a, 0x8a, 0xc7, 0x30, 0xec, 0xc3, 0x2e,
+	0x78, 0x82, 0xb6, 0x15, 0x07, 0xcd, 0xb7, 0x48, 0x6b, 0x83, 0x61, 0xf9, 0xb1, 0xfb, 0xac, 0x26,
+	0x43, 0x41, 0x2f, 0xe7, 0x84, 0x07, 0xba, 0x1d, 0x66, 0x26, 0xab, 0x27, 0x71, 0x25, 0x24, 0xff,
+	0xae, 0x04, 0xce, 0x15, 0x10, 0xac, 0xa2, 0x8b, 0x07, 0x16, 0x1d, 0x1e, 0x1e, 0x42, 0x63, 0xae,
+	0xdc, 0xba, 0x61, 0xfc, 0xc4, 0xc3, 0x3c, 0xfe, 0x05, 0x07, 0xfa, 0xb6, 0xcd, 0xa7, 0x05, 0x00,
+	0x00,
+};
+
+static const WebAsset webAssets[] = {
+	{ "/", "text/html", "\"83b9f3c0d965d463\"", web_index_html_gz, sizeof(web_index_html_gz) },
+};
@@ -1,92 +1,232 @@
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
 #include "fs/fsCompat.h"
 
 #include "app/sessionManager.h"
+#include "app/nutPipeline.h"
 #include "UI/uiFacade.h"
 #include "UI/alertSystem.h"
 #include "net/webPortal.h"
+#include "net/webAssets.h"
+#include "net/httpLatency.h"
+#include "net/sessionArchive.h"
+#include "net/sessionList.h"
+#include "net/simBulk.h"
+#include "net/eventFeed.h"
+#include "fs/jsonWriter.h"
+#include "app/metrics.h"
+#include <memory>
 
-static WebServer server(80);
+/* Threading: request handlers run on the AsyncTCP task; the nut sink, the Unknown
+ * prompt callback and the group-commit poll run on the loop thread. Everything that
+ * touches gSession holds sessionMutex; UI/alert posting is already cross-task safe.
+ * Handlers wait at most WEB_SESSION_WAIT_MS for it and answer 503 otherwise: a blocked
+ * AsyncTCP task would stall every connection, not just this request. */
+#ifndef WEB_SESSION_WAIT_MS
+#define WEB_SESSION_WAIT_MS		250
+#endif
+
+static AsyncWebServer server(80);
 static SessionManager gSession;
+static SemaphoreHandle_t sessionMutex = nullptr;
+
+struct SessionLock {
+	explicit SessionLock(TickType_t wait = portMAX_DELAY)
+		: held(xSemaphoreTake(sessionMutex, wait) == pdTRUE) {}
+	~SessionLock() { if (held) xSemaphoreGive(sessionMutex); }
+	explicit operator bool() const { return held; }
+	const bool held;
+};
+
+// AsyncTCP handlers: SessionLock lk(HANDLER_WAIT); if (!lk) { sendBusy(req); return; }
+static const TickType_t HANDLER_WAIT = pdMS_TO_TICKS(WEB_SESSION_WAIT_MS);
 
 static const char* apSsid = "Areca-Classifier";
 static const char* apPass = "";	// unsecured
 
-static String htmlHeader() {
-	String h;
-	h += "<!doctype html><html><head><meta name='viewport' content='width=device-width,initial-scale=1'>";
-	h += "<style>body{font-family:system-ui,Arial;margin:16px} .row{display:flex;gap:8px;flex-wrap:wrap;margin:8px 0} button{padding:8px 12px}</style>";
-	h += "</head><body><h1>Areca Classifier</h1>";
-	return h;
+// Bundled UI (web/ -> tools/embed_web.py): gzip'd in flash, sent without copying.
+// Browsers revalidate every load ("no-cache") and get a bodyless 304 while the ETag holds.
+static void sendAsset(AsyncWebServerRequest* req, const WebAsset& a) {
+	AsyncWebServerResponse* r;
+	if (req->hasHeader("If-None-Match") && req->header("If-None-Match") == a.etag) {
+		r = req->beginResponse(304);
+	} else {
+		r = req->beginResponse(200, a.type, a.gz, a.gzLen);
+		r->addHeader("Content-Encoding", "gzip");
+	}
+	r->addHeader("ETag", a.etag);
+	r->addHeader("Cache-Control", "no-cache");
+	req->send(r);
 }
 
-static void sendIndex() {
-	String html = htmlHeader();
-	html += "<h2>Session</h2><div class='row'>"
-	        "<form method='post' action='/api/session/start'><button>Start Session</button></form>"
-	        "<form method='post' action='/api/session/end'><button>End Session</button></form></div>";
+static void sendJsonOk(AsyncWebServerRequest* req, const char* s)  { req->send(200, "application/json", s); }
+static void sendJsonErr(AsyncWebServerRequest* req, const char* s) { req->send(500, "application/json", s); }
 
-	html += "<h2>Simulate</h2><div class='row'>"
-	        "<form method='post' action='/api/simulate?class=Api'><button>+ Api</button></form>"
-	        "<form method='post' action='/api/simulate?class=Seconds'><button>+ Seconds</button></form>"
-	        "<form method='post' action='/api/simulate?class=Rashi'><button>+ Rashi</button></form>"
-	        "<form method='post' action='/api/simulate?class=Mangala'><button>+ Mangala</button></form>"
-	        "<form method='post' action='/api/simulate?class=Unknown'><button>+ Unknown</button></form>"
-	        "</div>";
+static void sendBusy(AsyncWebServerRequest* req) {
+	AsyncWebServerResponse* r = req->beginResponse(503, "application/json", "{\"error\":\"session busy\"}");
+	r->addHeader("Retry-After", "1");
+	req->send(r);
+}
+
+// JSON bodies are emitted into a stack buffer; the server copies them once into its send path
+static const size_t JSON_RESPONSE_MAX = 448;
+
+static void sendJson(AsyncWebServerRequest* req, const BufferPrint& out) {
+	if (out.overflow()) { sendJsonErr(req, "{\"error\":\"response too large\"}"); return; }
+	req->send(200, "application/json", out.c_str());
+}
+
+static void writeCounts(JsonWriter& js, const ClassCounts& cc) {
+	js.beginObject("counts")
+	  .field("Api", cc.api).field("Seconds", cc.seconds).field("Rashi", cc.rashi).field("Mangala", cc.mangala)
+	  .endObject();
+}
 
-	html += "<div class='row'><a href='/health'>Health</a></div>";
-	html += "</body></html>";
-	server.send(200, "text/html", html);
+static void writePercents(JsonWriter& js, float a, float s, float r, float m) {
+	js.beginObject("percents")
+	  .field1("Api", a).field1("Seconds", s).field1("Rashi", r).field1("Mangala", m)
+	  .endObject();
 }
 
-static void sendJsonOk(const String &s)  { server.send(200, "application/json", s); }
-static void sendJsonErr(const String &s) { server.send(500, "application/json", s); }
+static void handleHealth(AsyncWebServerRequest* req) { req->send(200, "text/plain", "OK"); }
 
-static void handleHealth() { server.send(200, "text/plain", "OK"); }
+// Set once the operator has been told this session's log failed; cleared by a new session
+static bool logErrorShown = false;
 
-static void handleStart() {
-	bool ok = gSession.startSession();
+// POST /api/session/start[?t=<UTC epoch seconds>]: 't' sets the clock if nothing has yet
+static void handleStart(AsyncWebServerRequest* req) {
+	if (req->hasParam("t")) SessionManager::setClock(strtoul(req->getParam("t")->value().c_str(), nullptr, 10));
+	bool ok;
+	{
+		SessionLock lk(HANDLER_WAIT);
+		if (!lk) { sendBusy(req); return; }
+		ok = gSession.startSession();
+		if (ok) logErrorShown = false;
+		if (ok) eventFeedPublish(FeedEventType::Session, gSession.getCounts());
+	}
 	if (ok) {
-		uiFacadeClearBatchResult();
+		uiFacadePostClearBatchResult();
 		uiFacadePostPercentages(0,0,0,0);
-		sendJsonOk("{\"ok\":true}");
+		sendJsonOk(req, "{\"ok\":true}");
 	} else {
-		sendJsonErr("{\"ok\":false,\"err\":\"mkdir or path conflict\"}");
+		sendJsonErr(req, "{\"ok\":false,\"err\":\"mkdir or path conflict\"}");
 	}
 }
 
-static void handleSim() {
-	if (!server.hasArg("class")) { server.send(400, "application/json", "{\"error\":\"missing class\"}"); return; }
-	NutClass c = SessionManager::parseClass(server.arg("class"));
-
-	// Accept Unknown to exercise the prompt flow
-	if (!gSession.addSimulatedNut(c)) { sendJsonErr("{\"ok\":false}"); return; }
+/* A nut the session refused because its log failed: tell the operator and SSE subscribers
+   once per session, then keep counting the losses in /api/session/status. Caller holds the
+   session lock. */
+static void noteRecordFailed() {
+	if (!gSession.logFailed() || logErrorShown) return;
+	logErrorShown = true;
+	uiFacadePostLogError();
+	eventFeedPublish(FeedEventType::LogError, gSession.getCounts(), NutClass::Unknown, gSession.logDroppedRecords());
+}
 
+/* Known class: update percentages + flash alert. Unknown: show the on-device prompt;
+   counts stay unchanged until the operator picks. Caller holds the session lock. */
+static void publishNut(NutClass c) {
 	if (c == NutClass::Unknown) {
-		// Show on-device prompt; counts unchanged until user picks
-		uiFacadePostShowUnknownPrompt();
-		server.send(200, "application/json", "{\"ok\":true,\"info\":\"unknown modal shown on device\"}");
+		uiFacadePostShowUnknownPrompt(gSession.lastNutRef());	// the nut just logged
 		return;
 	}
-
-	// Known class: update counts, UI, and flash alert
-	ClassCounts cc = gSession.getCounts();
 	float a=0,s=0,r=0,m=0; gSession.getPercentages(a,s,r,m);
 	uiFacadePostPercentages((int)roundf(a), (int)roundf(s), (int)roundf(r), (int)roundf(m));
 	alertPostFlash(c);
+}
+
+static void handleSim(AsyncWebServerRequest* req) {
+	if (!req->hasParam("class")) { req->send(400, "application/json", "{\"error\":\"missing class\"}"); return; }
+	NutClass c = SessionManager::parseClass(req->getParam("class")->value());
+
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	{
+		SessionLock lk(HANDLER_WAIT);
+		if (!lk) { sendBusy(req); return; }
+		// Accept Unknown to exercise the prompt flow
+		if (!gSession.addSimulatedNut(c)) {
+			noteRecordFailed();
+			sendJsonErr(req, gSession.logFailed() ? "{\"ok\":false,\"err\":\"session log write failed\"}" : "{\"ok\":false}");
+			return;
+		}
+		publishNut(c);
+		eventFeedPublish(FeedEventType::Nut, gSession.getCounts(), c, gSession.lastIndex(), 255);
+
+		float a=0,s=0,r=0,m=0; gSession.getPercentages(a,s,r,m);
+		JsonWriter js(out);
+		js.beginObject().field("ok", true);
+		writeCounts(js, gSession.getCounts());
+		writePercents(js, a, s, r, m);
+		js.endObject();
+	}
+	if (c == NutClass::Unknown) {
+		req->send(200, "application/json", "{\"ok\":true,\"info\":\"unknown modal shown on device\"}");
+		return;
+	}
+	sendJson(req, out);
+}
 
-	char buf[256];
-	snprintf(buf, sizeof(buf),
-		"{\"ok\":true,\"counts\":{\"Api\":%u,\"Seconds\":%u,\"Rashi\":%u,\"Mangala\":%u},"
-		"\"percents\":{\"Api\":%.1f,\"Seconds\":%.1f,\"Rashi\":%.1f,\"Mangala\":%.1f}}",
-		(unsigned)cc.api,(unsigned)cc.seconds,(unsigned)cc.rashi,(unsigned)cc.mangala,
-		a,s,r,m);
-	sendJsonOk(String(buf));
+/* Bulk simulation sink (loop thread): same path as a detected nut */
+static bool simulateNut(NutClass c, const NutWindow* w) {
+	SessionLock lk;
+	const bool ok = w ? gSession.addReplayedNut(c, *w) : gSession.addSimulatedNut(c);
+	if (!ok) { noteRecordFailed(); return false; }
+	publishNut(c);
+	eventFeedPublish(FeedEventType::Nut, gSession.getCounts(), c, gSession.lastIndex(), 255);
+	return true;
 }
 
-static void handleEnd() {
+// POST /api/simulate/bulk?n=&rate=&dist=Api:40,Seconds:5,...&seed=  |  ?replay=<session id>
+// POST ...?cancel=1 stops the running job; GET returns the progress/report
+static void handleBulkStart(AsyncWebServerRequest* req) {
+	if (req->hasParam("cancel")) { simBulkCancel(); sendJsonOk(req, "{\"ok\":true}"); return; }
+
+	SimBulkConfig c;
+	if (req->hasParam("n"))    c.count = strtoul(req->getParam("n")->value().c_str(), nullptr, 10);
+	if (req->hasParam("rate")) c.ratePerSec = strtoul(req->getParam("rate")->value().c_str(), nullptr, 10);
+	if (req->hasParam("seed")) c.seed = strtoul(req->getParam("seed")->value().c_str(), nullptr, 10);
+	if (req->hasParam("dist") && !simBulkParseDist(req->getParam("dist")->value().c_str(), c.weight)) {
+		req->send(400, "application/json", "{\"error\":\"bad dist\"}");
+		return;
+	}
+	if (req->hasParam("replay")) {
+		const String& id = req->getParam("replay")->value();
+		if (!SessionArchive::validId(id.c_str())) { req->send(400, "application/json", "{\"error\":\"bad replay id\"}"); return; }
+		{
+			SessionLock lk(HANDLER_WAIT);
+			if (!lk) { sendBusy(req); return; }
+			if (gSession.isOpen() && gSession.currentPath() == "/sessions/" + id) {
+				req->send(409, "application/json", "{\"error\":\"cannot replay the open session into itself\"}");
+				return;
+			}
+		}
+		strncpy(c.replayId, id.c_str(), sizeof(c.replayId) - 1);
+		c.count = UINT32_MAX;		// until the log ends
+	}
+	if (c.count == 0) { req->send(400, "application/json", "{\"error\":\"n must be > 0\"}"); return; }
+	if (!simBulkStart(c)) { req->send(409, "application/json", "{\"error\":\"job already running\"}"); return; }
+
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	simBulkWriteReport(js);
+	req->send(202, "application/json", out.c_str());
+}
+
+static void handleBulkReport(AsyncWebServerRequest* req) {
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	simBulkWriteReport(js);
+	sendJson(req, out);
+}
+
+static void handleEnd(AsyncWebServerRequest* req) {
+	SessionLock lk(HANDLER_WAIT);
+	if (!lk) { sendBusy(req); return; }
 	bool ok = gSession.endSession();
 
 	ClassCounts cc = gSession.getCounts();
@@ -95,7 +235,7 @@ static void handleEnd() {
 
 	// Batch rules: Api >= 25%, Seconds in [2,7], Mangala < 2%
 	bool passed = false;
-	String why = "";
+	const char* why = "";
 	if (cc.total() > 0) {
 		if (api < 25.0f)					why = "api<25%";
 		else if (sec < 2.0f || sec > 7.0f)	why = "seconds out of [2,7]%";
@@ -107,60 +247,300 @@ static void handleEnd() {
 
 	gSession.writeResult(passed, api, sec, ras, man);
 	uiFacadePostBatchResult(passed);
+	eventFeedPublish(FeedEventType::Result, cc, NutClass::Unknown, 0, 0, passed);
+
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject().field("ok", ok).field("result", passed ? "pass" : "fail").field("why", why);
+	writePercents(js, api, sec, ras, man);
+	js.endObject();
+	sendJson(req, out);
+}
+
+// Persistence state: counts are served from RAM; pending* is what a power cut would lose
+static void handleStatus(AsyncWebServerRequest* req) {
+	SessionLock lk(HANDLER_WAIT);
+	if (!lk) { sendBusy(req); return; }
+	ClassCounts cc = gSession.getCounts();
+	const EventFeedStats ev = eventFeedGetStats();
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject().field("open", gSession.isOpen());
+	writeCounts(js, cc);
+	js.field("pendingBytes", gSession.pendingBytes())
+	  .field("pendingMs", gSession.pendingMs())
+	  .field("maxLossMs", SessionManager::maxLossMs())
+	  .field("flashBytes", gSession.flashBytesWritten())
+	  .field("clockSet", SessionManager::clockSet())
+	  .field("logFailed", gSession.logFailed())
+	  .field("logDropped", gSession.logDroppedRecords());
+	js.beginObject("sse")
+	  .field("clients", ev.clients).field("published", ev.published).field("delivered", ev.delivered)
+	  .field("dropped", ev.dropped).field("coalesced", ev.coalesced)
+	  .endObject();
+	js.endObject();
+	sendJson(req, out);
+}
+
+// POST /api/reclassify/undo|redo: step through the operator's corrections
+static void handleCorrection(AsyncWebServerRequest* req, bool undo) {
+	SessionLock lk(HANDLER_WAIT);
+	if (!lk) { sendBusy(req); return; }
+	NutCorrection c = {};
+	if (!(undo ? gSession.undoCorrection(&c) : gSession.redoCorrection(&c))) {
+		req->send(409, "application/json", "{\"ok\":false,\"err\":\"nothing to do\"}");
+		return;
+	}
+	float a=0,s=0,r=0,m=0; gSession.getPercentages(a,s,r,m);
+	uiFacadePostPercentages((int)roundf(a), (int)roundf(s), (int)roundf(r), (int)roundf(m));
+
+	const uint8_t now = undo ? c.fromOv : c.toOv;
+	const NutClass eff = now != NUT_OVERRIDE_NONE ? (NutClass)now : (NutClass)c.pred;
+	ClassCounts cc = gSession.getCounts();
+	eventFeedPublish(FeedEventType::Reclass, cc, eff, c.index);
+	char buf[JSON_RESPONSE_MAX];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject().field("ok", true).field("nut", c.index).field("class", SessionManager::className(eff))
+	  .field("undo", gSession.undoDepth()).field("redo", gSession.redoDepth());
+	writeCounts(js, cc);
+	js.endObject();
+	sendJson(req, out);
+}
+
+// GET /api/http/latency[?reset=1]: handler time percentiles over the recent window
+static void handleLatency(AsyncWebServerRequest* req) {
+	const HttpLatencyStats st = httpLatencyGetStats();
+	char buf[160];
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter(out).beginObject()
+		.field("requests", st.requests).field("window", st.window)
+		.field("p50Us", st.p50Us).field("p99Us", st.p99Us).field("maxUs", st.maxUs)
+		.endObject();
+	if (req->hasParam("reset")) httpLatencyReset();
+	sendJson(req, out);
+}
+
+// Prometheus scrape; a few KB, built into the stream's buffer
+static void handleMetrics(AsyncWebServerRequest* req) {
+	AsyncResponseStream* res = req->beginResponseStream("text/plain; version=0.0.4");
+	res->addHeader("Cache-Control", "no-store");
+	metricsWrite(*res);
+	req->send(res);
+}
+
+// "bytes=a-b" | "bytes=a-" | "bytes=-n" (single range only)
+static bool parseRange(const char* h, uint32_t size, uint32_t& first, uint32_t& last) {
+	if (strncmp(h, "bytes=", 6) != 0 || strchr(h, ',') || size == 0) return false;
+	const char* dash = strchr(h + 6, '-');
+	if (!dash) return false;
+	if (dash == h + 6) {						// suffix: last n bytes
+		const uint32_t n = strtoul(dash + 1, nullptr, 10);
+		if (n == 0) return false;
+		first = n >= size ? 0 : size - n;
+		last  = size - 1;
+		return true;
+	}
+	first = strtoul(h + 6, nullptr, 10);
+	last  = dash[1] ? strtoul(dash + 1, nullptr, 10) : size - 1;
+	if (last >= size) last = size - 1;
+	return first <= last;
+}
+
+// GET /api/sessions/<id>/archive: tar of the session folder, streamed from flash.
+// Full downloads are chunked; "Range" (optionally with "If-Range") returns 206.
+static void sendArchive(AsyncWebServerRequest* req, const String& id) {
+	if (!SessionArchive::validId(id.c_str())) { req->send(400, "application/json", "{\"error\":\"bad id\"}"); return; }
+	uint16_t edits;
+	{
+		// the live session's pending nuts (and its edit count) belong in the download
+		SessionLock lk(HANDLER_WAIT);
+		if (!lk) { sendBusy(req); return; }
+		if (gSession.isOpen() && gSession.currentPath() == "/sessions/" + id) gSession.flush();
+		edits = gSession.logEdits(id.c_str());
+	}
+	std::shared_ptr<SessionArchive> ar = std::make_shared<SessionArchive>();
+	if (!ar->open(id.c_str(), edits)) { req->send(404, "application/json", "{\"error\":\"no such session\"}"); return; }
+
+	char etag[12];
+	snprintf(etag, sizeof(etag), "\"%08x\"", (unsigned)ar->etag());
+	const uint32_t size = ar->size();
+	uint32_t first = 0, last = size - 1;
+	bool partial = false;
+	if (req->hasHeader("Range") && (!req->hasHeader("If-Range") || req->header("If-Range") == etag)) {
+		if (!parseRange(req->header("Range").c_str(), size, first, last)) {
+			AsyncWebServerResponse* r = req->beginResponse(416, "text/plain", "bad range");
+			char cr[24];
+			snprintf(cr, sizeof(cr), "bytes */%u", (unsigned)size);
+			r->addHeader("Content-Range", cr);
+			req->send(r);
+			return;
+		}
+		partial = true;
+	}
+
+	// one SessionArchive (file table + one open handle) per download, whatever its size.
+	// A failed read aborts the connection: ending the stream would pass a truncated tar
+	// off as complete. (AsyncTCP delivers the resulting error event after this returns.)
+	const uint32_t len = last - first + 1;
+	auto fill = [ar, req, first, len](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+		if (index >= len) return 0;
+		const size_t n = ar->read(first + index, buf, maxLen < len - index ? maxLen : len - index);
+		if (ar->failed()) {
+			req->client()->abort();
+			return 0;
+		}
+		return n;
+	};
+	AsyncWebServerResponse* resp;
+	if (partial) {
+		resp = req->beginResponse("application/x-tar", len, fill);
+		resp->setCode(206);
+		char cr[48];
+		snprintf(cr, sizeof(cr), "bytes %u-%u/%u", (unsigned)first, (unsigned)last, (unsigned)size);
+		resp->addHeader("Content-Range", cr);
+	} else {
+		resp = req->beginChunkedResponse("application/x-tar", fill);
+	}
+	resp->addHeader("Accept-Ranges", "bytes");
+	resp->addHeader("ETag", etag);
+	char cd[64];
+	snprintf(cd, sizeof(cd), "attachment; filename=\"%s.tar\"", id.c_str());
+	resp->addHeader("Content-Disposition", cd);
+	req->send(resp);
+}
 
-	char buf[256];
-	snprintf(buf, sizeof(buf),
-		"{\"ok\":%s,\"result\":\"%s\",\"why\":\"%s\",\"percents\":{\"Api\":%.1f,\"Seconds\":%.1f,\"Rashi\":%.1f,\"Mangala\":%.1f}}",
-		ok ? "true" : "false",
-		passed ? "pass" : "fail",
-		why.c_str(), api, sec, ras, man);
-	sendJsonOk(String(buf));
+// GET /api/sessions?offset=&limit=&from=&to=&status=any|open|closed|pass|fail
+// from/to are UTC epoch seconds, matched against session ids (sequence stamps for sessions
+// started before the clock was set; see SessionManager::setClock). Streamed from the session index, one entry at a time.
+static void sendSessionList(AsyncWebServerRequest* req) {
+	SessionQuery q;
+	auto num = [req](const char* name, uint32_t& out) {
+		if (req->hasParam(name)) out = strtoul(req->getParam(name)->value().c_str(), nullptr, 10);
+	};
+	num("offset", q.offset);
+	num("limit", q.limit);
+	num("from", q.from);
+	num("to", q.to);
+	if (req->hasParam("status") && !SessionListStream::parseStatus(req->getParam("status")->value().c_str(), q.status)) {
+		req->send(400, "application/json", "{\"error\":\"bad status\"}");
+		return;
+	}
+
+	std::shared_ptr<SessionListStream> list = std::make_shared<SessionListStream>();
+	if (!list->begin(q)) { sendJsonErr(req, "{\"error\":\"session index unavailable\"}"); return; }
+	req->send(req->beginChunkedResponse("application/json",
+		[list](uint8_t* buf, size_t maxLen, size_t) -> size_t { return list->read(buf, maxLen); }));
 }
 
-/* When the operator chooses a class in the Unknown prompt */
-static void onUnknownCommit(NutClass chosen) {
+// /api/sessions and its sub-resources
+static void handleSessions(AsyncWebServerRequest* req) {
+	static const char prefix[] = "/api/sessions/";
+	static const char archive[] = "/archive";
+	const String& url = req->url();
+	if (url == "/api/sessions" || url == prefix) {
+		sendSessionList(req);
+		return;
+	}
+	if (url.startsWith(prefix) && url.endsWith(archive)) {
+		sendArchive(req, url.substring(sizeof(prefix) - 1, url.length() - (sizeof(archive) - 1)));
+		return;
+	}
+	req->send(404, "text/plain", "not found");
+}
+
+/* When the operator chooses a class in the Unknown prompt (loop thread). Prompts queue up
+   while nuts keep arriving, so the pick goes to the nut its prompt was raised for. */
+static void onUnknownCommit(NutClass chosen, const NutRef& nut) {
 	if (chosen == NutClass::Unknown) return;
+	SessionLock lk;
 	NutClass oldC = NutClass::Unknown;
-	if (gSession.reclassifyLast(chosen, &oldC)) {
-		ClassCounts cc = gSession.getCounts();
-		float a=0,s=0,r=0,m=0; gSession.getPercentages(a,s,r,m);
-		uiFacadePostPercentages((int)roundf(a), (int)roundf(s), (int)roundf(r), (int)roundf(m));
-		alertPostFlash(chosen);
+	uint32_t index = 0;
+	if (!gSession.reclassifyAt(nut, chosen, &oldC, &index)) {
+		Serial.printf("[WEB] Unknown pick for record @%u not applied (session changed?)\n", (unsigned)nut.recOffset);
+		return;
 	}
+	publishNut(chosen);
+	eventFeedPublish(FeedEventType::Reclass, gSession.getCounts(), chosen, index);
+}
+
+/* Segmented nut from the ADC pipeline (delivered on the loop thread) */
+static void onNutDetected(const NutDetection& d) {
+	SessionLock lk;
+	// Low-confidence nuts arrive as Unknown and reuse the operator prompt
+	if (!gSession.addNut(d.result.cls, d.window, d.result.confidence)) { noteRecordFailed(); return; }
+	publishNut(d.result.cls);
+	eventFeedPublish(FeedEventType::Nut, gSession.getCounts(), d.result.cls, gSession.lastIndex(), d.result.confidence);
+}
+
+// Every API handler is timed into the latency window
+static ArRequestHandlerFunction timed(ArRequestHandlerFunction fn) {
+	return [fn](AsyncWebServerRequest* req) {
+		const uint32_t t0 = micros();
+		fn(req);
+		const uint32_t us = micros() - t0;
+		httpLatencyRecord(us);
+		metricHttpUs.observe(us);
+	};
 }
 
+static void sendNoContent(AsyncWebServerRequest* req) { req->send(204); }
+
 void webPortalBegin() {
 	WiFi.mode(WIFI_AP);
 	WiFi.softAP(apSsid, apPass);
 	Serial.printf("[WEB] SoftAP %s started, IP: %s\n", apSsid, WiFi.softAPIP().toString().c_str());
 
+	sessionMutex = xSemaphoreCreateMutex();
 	gSession.begin();
+	if (gSession.resumeIfOpen()) {	// pick up where a reboot left off
+		float a=0,s=0,r=0,m=0; gSession.getPercentages(a,s,r,m);
+		uiFacadePostPercentages((int)roundf(a), (int)roundf(s), (int)roundf(r), (int)roundf(m));
+	}
+	eventFeedPublish(FeedEventType::Session, gSession.getCounts());	// first "sync" for subscribers
 	uiFacadeRegisterUnknownCommit(onUnknownCommit);	// bridge UI selection -> session update
-	alertInit();					// set up flasher contexts after UI is ready
+	nutPipelineRegisterSink(onNutDetected);		// segmented ADC nuts -> session
+	simBulkBegin(simulateNut);					// /api/simulate/bulk -> session
 
 	// quiet browser probes
-	server.on("/favicon.ico", HTTP_GET, [](){ server.send(204); });
-	server.on("/generate_204", HTTP_GET, [](){ server.send(204); });
-	server.on("/hotspot-detect.html", HTTP_GET, [](){ server.send(204); });
-	server.on("/connecttest.txt", HTTP_GET, [](){ server.send(204); });
-	server.on("/ncsi.txt", HTTP_GET, [](){ server.send(204); });
+	server.on("/favicon.ico", HTTP_GET, sendNoContent);
+	server.on("/generate_204", HTTP_GET, sendNoContent);
+	server.on("/hotspot-detect.html", HTTP_GET, sendNoContent);
+	server.on("/connecttest.txt", HTTP_GET, sendNoContent);
+	server.on("/ncsi.txt", HTTP_GET, sendNoContent);
 
-	server.on("/", HTTP_GET, sendIndex);
-	server.on("/health", HTTP_GET, handleHealth);
-	server.on("/favicon.ico", HTTP_GET, [](){ server.send(204); });								// silence browser noise
-	server.on("/generate_204", HTTP_GET, [](){ server.send(204); });
-	server.on("/hotspot-detect.html", HTTP_GET, [](){ server.send(204); });
-	server.on("/connecttest.txt", HTTP_GET, [](){ server.send(204); });
-	server.on("/ncsi.txt", HTTP_GET, [](){ server.send(204); });
+	for (const WebAsset& a : webAssets) {
+		server.on(a.path, HTTP_GET, timed([&a](AsyncWebServerRequest* r){ sendAsset(r, a); }));
+	}
+	server.on("/health", HTTP_GET, timed(handleHealth));
 
-	server.on("/api/session/start", HTTP_POST, handleStart);
-	server.on("/api/simulate", HTTP_POST, handleSim);
-	server.on("/api/session/end", HTTP_POST, handleEnd);
+	server.on("/api/session/start", HTTP_POST, timed(handleStart));
+	server.on("/api/simulate/bulk", HTTP_POST, timed(handleBulkStart));	// before /api/simulate (prefix match)
+	server.on("/api/simulate/bulk", HTTP_GET, timed(handleBulkReport));
+	server.on("/api/simulate", HTTP_POST, timed(handleSim));
+	server.on("/api/session/end", HTTP_POST, timed(handleEnd));
+	server.on("/api/session/status", HTTP_GET, timed(handleStatus));
+	server.on("/api/reclassify/undo", HTTP_POST, timed([](AsyncWebServerRequest* r){ handleCorrection(r, true); }));
+	server.on("/api/reclassify/redo", HTTP_POST, timed([](AsyncWebServerRequest* r){ handleCorrection(r, false); }));
+	server.on("/api/sessions", HTTP_GET, timed(handleSessions));	// also matches /api/sessions/*
+	server.on("/api/http/latency", HTTP_GET, timed(handleLatency));
+	server.on("/metrics", HTTP_GET, timed(handleMetrics));
+	server.on("/api/ui/redraw", HTTP_POST, timed([](AsyncWebServerRequest* r){ uiFacadePostRedraw(); sendJsonOk(r, "{\"ok\":true}"); }));
+	eventFeedBegin(server);		// GET /api/events (SSE)
+	server.onNotFound([](AsyncWebServerRequest* req){ req->send(404, "text/plain", "not found"); });
 
-	server.begin();
-	Serial.println("[WEB] HTTP server started on :80");
+	server.begin();	// AsyncTCP task from here on; nothing to pump in loop()
+	Serial.println("[WEB] async HTTP server started on :80");
 }
 
 void webPortalPoll() {
-	server.handleClient();
+	simBulkPoll();
+	eventFeedPump();
+	// group-commit deadline for session persistence; if a handler holds the session,
+	// don't stall the UI loop behind it -- the deadline is checked again next pass
+	if (xSemaphoreTake(sessionMutex, 0) != pdTRUE) return;
+	gSession.poll();
+	xSemaphoreGive(sessionMutex);
 }
@@ -1,7 +1,8 @@
 #pragma once
 
-// Starts SPIFFS, SoftAP, and the web server (open AP: "Areca-Classifier").
+// Starts SoftAP and the async web server (open AP: "Areca-Classifier").
+// Requests are served on the AsyncTCP task, not from loop().
 void webPortalBegin();
 
-// Non-blocking HTTP handler; call from loop().
+// Loop-thread housekeeping (SSE pump, session group commit); never blocks on HTTP work.
 void webPortalPoll();
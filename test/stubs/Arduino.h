@@ -0,0 +1,39 @@
+#pragma once
+// Host stand-in for the bits of Arduino.h used by the natively tested sources
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+
+class String : public std::string {
+public:
+	String() {}
+	String(const char* s) : std::string(s ? s : "") {}
+	String(const std::string& s) : std::string(s) {}
+};
+inline String operator+(const String& a, const char* b) { String r(a); r.append(b); return r; }
+inline String operator+(const String& a, const String& b) { String r(a); r.append(b); return r; }
+
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* p, size_t n) { size_t k = 0; while (n-- && write(*p++)) ++k; return k; }
+	size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+	size_t print(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lu", v); return print(b); }
+	size_t print(long v) { char b[24]; snprintf(b, sizeof(b), "%ld", v); return print(b); }
+};
+
+struct HostSerial {
+	void printf(const char* fmt, ...) { va_list a; va_start(a, fmt); vprintf(fmt, a); va_end(a); }
+	void println(const char* s) { puts(s); }
+};
+inline HostSerial Serial;
+
+inline uint32_t micros() {
+	using namespace std::chrono;
+	return (uint32_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+inline uint32_t millis() { return micros() / 1000; }
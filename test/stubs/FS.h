@@ -0,0 +1,114 @@
+#pragma once
+/* Host stand-in for the Arduino FS API with LittleFS commit semantics and power cuts
+ *
+ * - A file's new content is committed when it is closed; creating a file and each
+ *   rename/remove commit on their own. Those are the "steps" a power cut can fall between.
+ * - fs::faults.stepsLeft = n lets n steps through, then cuts power: from then on nothing
+ *   is committed and every mutation fails. fs::faults.reboot() restores power.
+ * - fs::faults.spaceLeft = n lets n more bytes be written, then writes come back short
+ *   (flash full); -1 = unlimited
+ */
+#include <Arduino.h>
+#include <map>
+#include <memory>
+
+namespace fs {
+
+struct FaultState {
+	std::map<std::string, std::string> files;	// committed content
+	int  stepsLeft = -1;	// steps until the power cut (-1 = never)
+	bool cut = false;
+	int  steps = 0;			// steps committed so far
+	long spaceLeft = -1;	// bytes writable before the flash is full (-1 = unlimited)
+
+	bool step() {
+		if (cut) return false;
+		if (stepsLeft == 0) { cut = true; return false; }
+		if (stepsLeft > 0) --stepsLeft;
+		++steps;
+		return true;
+	}
+	void reboot() { cut = false; stepsLeft = -1; spaceLeft = -1; }
+	void format() { files.clear(); steps = 0; reboot(); }
+};
+inline FaultState faults;
+
+class File {
+public:
+	File() {}
+	File(const std::string& path, const std::string& data, bool writable, bool readable, size_t pos = 0)
+		: _path(path), _data(std::make_shared<std::string>(data)), _writable(writable), _readable(readable), _pos(pos) {}
+
+	explicit operator bool() const { return (bool)_data; }
+	size_t size() const { return _data ? _data->size() : 0; }
+	size_t position() const { return _pos; }
+	bool seek(uint32_t pos) {
+		if (!_data || pos > _data->size()) return false;
+		_pos = pos;
+		return true;
+	}
+
+	size_t read(uint8_t* buf, size_t n) {
+		if (!_data || !_readable || _pos >= _data->size()) return 0;
+		const size_t k = _pos + n <= _data->size() ? n : _data->size() - _pos;
+		memcpy(buf, _data->data() + _pos, k);
+		_pos += k;
+		return k;
+	}
+	// Overwrites at the position and extends the file past its end
+	size_t write(const uint8_t* buf, size_t n) {
+		if (!_data || !_writable || faults.cut) return 0;
+		if (faults.spaceLeft >= 0 && (long)n > faults.spaceLeft) n = (size_t)faults.spaceLeft;
+		if (faults.spaceLeft >= 0) faults.spaceLeft -= (long)n;
+		_data->replace(_pos, n < _data->size() - _pos ? n : _data->size() - _pos, (const char*)buf, n);
+		_pos += n;
+		return n;
+	}
+	void close() {
+		if (_data && _writable && faults.step()) faults.files[_path] = *_data;
+		_data.reset();
+	}
+
+private:
+	std::string _path;
+	std::shared_ptr<std::string> _data;	// read: snapshot; write: pending content
+	bool   _writable = false;
+	bool   _readable = false;
+	size_t _pos = 0;
+};
+
+class FS {
+public:
+	bool begin(bool = true) { return true; }
+	bool exists(const String& p) { return faults.files.count(p) != 0; }
+
+	// "r", "r+" (existing file, read/overwrite), "w" (truncate) or "a" (append); the
+	// new content is committed on close
+	File open(const String& p, const char* mode = "r") {
+		const std::string m(mode);
+		auto it = faults.files.find(p);
+		if (m == "r")  return it == faults.files.end() ? File() : File(p, it->second, false, true);
+		if (m == "r+") return it == faults.files.end() ? File() : File(p, it->second, true, true);
+		if (it == faults.files.end()) {
+			if (!faults.step()) return File();
+			it = faults.files.emplace(p, std::string()).first;	// created empty
+		}
+		if (m == "a") return File(p, it->second, true, false, it->second.size());
+		return File(p, "", true, false);
+	}
+	bool rename(const String& from, const String& to) {
+		auto it = faults.files.find(from);
+		if (it == faults.files.end() || !faults.step()) return false;
+		std::string data = it->second;
+		faults.files.erase(it);
+		faults.files[to] = data;
+		return true;
+	}
+	bool remove(const String& p) {
+		if (!faults.files.count(p) || !faults.step()) return false;
+		faults.files.erase(p);
+		return true;
+	}
+};
+
+} // namespace fs
@@ -0,0 +1,10 @@
+#pragma once
+// Host stand-in for app/metrics.h: the metrics the natively tested sources touch, as no-ops
+#include <stdint.h>
+
+struct MetricCounter   { void inc(uint32_t = 1) {} };
+struct MetricHistogram { void observe(uint32_t) {} };
+
+enum : uint8_t { METRIC_FS_LOG = 0, METRIC_FS_JSON = 1, METRIC_FS_INDEX = 2 };
+inline MetricHistogram metricFsOpUs[3];
+inline MetricCounter   metricFlashBytes[3];
@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include "UI/alertEngine.h"
+
+// Every heap allocation in this binary is counted; the engine must not make any
+static size_t allocations = 0;
+void* operator new(size_t n) { allocations++; void* p = malloc(n ? n : 1); if (!p) throw std::bad_alloc(); return p; }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static const uint16_t DOUBLE_STEPS[] = { 120, 120, 120, 640 };
+static const uint16_t BLINK_STEPS[]  = { 250, 250 };
+static const AlertPatternDef DOUBLE = { DOUBLE_STEPS, 4 };
+static const AlertPatternDef BLINK  = { BLINK_STEPS, 2 };
+
+struct Obj { int id; };
+struct Slot { Obj* obj; AlertTiming t; };
+
+static Slot slots[4];
+static Obj objs[6];
+
+void setUp() {
+	for (Slot& s : slots) s = Slot{};
+	allocations = 0;
+}
+void tearDown() {}
+
+static void test_single_cycle_steps_and_expiry() {
+	AlertTiming t;
+	t.start(&DOUBLE, 1, 1000);
+	TEST_ASSERT_TRUE(t.on());
+	TEST_ASSERT_TRUE(t.advance(1119) == AlertAdvance::Unchanged);
+	TEST_ASSERT_TRUE(t.advance(1120) == AlertAdvance::Changed);
+	TEST_ASSERT_FALSE(t.on());
+	TEST_ASSERT_TRUE(t.advance(1240) == AlertAdvance::Changed);
+	TEST_ASSERT_TRUE(t.on());
+	TEST_ASSERT_TRUE(t.advance(1360) == AlertAdvance::Changed);
+	TEST_ASSERT_FALSE(t.on());
+	TEST_ASSERT_TRUE(t.advance(1999) == AlertAdvance::Unchanged);
+	TEST_ASSERT_TRUE(t.advance(2000) == AlertAdvance::Finished);	// one cycle = 1 s
+}
+
+static void test_late_tick_catches_up_on_absolute_boundaries() {
+	AlertTiming t;
+	t.start(&BLINK, 0, 0);						// until stopped
+	TEST_ASSERT_TRUE(t.advance(1260) == AlertAdvance::Changed);	// 5 steps late
+	TEST_ASSERT_FALSE(t.on());					// 1250..1500 is an OFF step
+	TEST_ASSERT_EQUAL_UINT32(1500, t.stepEndMs);	// not 1260 + 250
+	for (uint32_t now = 1500; now < 100000; now += 250) TEST_ASSERT_TRUE(t.advance(now) == AlertAdvance::Changed);
+}
+
+static void test_multi_cycle_count() {
+	AlertTiming t;
+	t.start(&BLINK, 3, 0);
+	TEST_ASSERT_TRUE(t.advance(1499) == AlertAdvance::Changed);
+	TEST_ASSERT_TRUE(t.advance(1500) == AlertAdvance::Finished);
+}
+
+static void test_tick_wraparound() {
+	AlertTiming t;
+	t.start(&BLINK, 1, 0xFFFFFF00u);			// crosses the 32-bit tick wrap
+	TEST_ASSERT_TRUE(t.advance(0xFFFFFFF0u) == AlertAdvance::Unchanged);
+	TEST_ASSERT_TRUE(t.advance(0xFFFFFF00u + 250) == AlertAdvance::Changed);
+	TEST_ASSERT_TRUE(t.advance(0xFFFFFF00u + 500) == AlertAdvance::Finished);
+}
+
+static void test_slot_allocation() {
+	bool stolen;
+	Slot* a = alertPickSlot(slots, 4, &objs[0], 0, &stolen);
+	TEST_ASSERT_TRUE(a == &slots[0]);
+	TEST_ASSERT_FALSE(stolen);
+	a->obj = &objs[0]; a->t.start(&DOUBLE, 1, 0);
+
+	// the same object gets its own slot back (restart), others take free ones in order
+	TEST_ASSERT_TRUE(alertPickSlot(slots, 4, &objs[0], 10, &stolen) == &slots[0]);
+	for (int i = 1; i < 4; ++i) {
+		Slot* s = alertPickSlot(slots, 4, &objs[i], 10 * i, &stolen);
+		TEST_ASSERT_TRUE(s == &slots[i]);
+		TEST_ASSERT_FALSE(stolen);
+		s->obj = &objs[i]; s->t.start(&DOUBLE, 1, 10 * i);
+	}
+
+	// all busy: the longest-running one is recycled
+	slots[0].t.startMs = 25;					// slot 1 (started at 10) is now the oldest
+	Slot* s = alertPickSlot(slots, 4, &objs[4], 100, &stolen);
+	TEST_ASSERT_TRUE(stolen);
+	TEST_ASSERT_TRUE(s == &slots[1]);
+
+	// a slot freed by expiry is reused before anything is stolen
+	slots[2].obj = nullptr;
+	TEST_ASSERT_TRUE(alertPickSlot(slots, 4, &objs[5], 100, &stolen) == &slots[2]);
+	TEST_ASSERT_FALSE(stolen);
+}
+
+static void test_next_wake() {
+	TEST_ASSERT_EQUAL(-1, alertNextWakeMs(slots, 4, 0));	// nothing busy: pause
+	slots[1].obj = &objs[1]; slots[1].t.start(&DOUBLE, 1, 0);	// boundary at 120
+	slots[3].obj = &objs[3]; slots[3].t.start(&BLINK, 1, 0);	// boundary at 250
+	TEST_ASSERT_EQUAL(120, alertNextWakeMs(slots, 4, 0));
+	TEST_ASSERT_EQUAL(20, alertNextWakeMs(slots, 4, 100));
+	TEST_ASSERT_EQUAL(1, alertNextWakeMs(slots, 4, 130));		// overdue: wake now
+}
+
+static void test_flashing_does_not_allocate() {
+	bool stolen;
+	uint32_t now = 0;
+	for (int round = 0; round < 500; ++round, now += 7) {
+		Obj* o = &objs[round % 6];
+		Slot* s = alertPickSlot(slots, 4, o, now, &stolen);
+		if (stolen) s->obj = nullptr;
+		s->obj = o;
+		s->t.start(round & 1 ? &BLINK : &DOUBLE, 1 + round % 3, now);
+		for (Slot& x : slots)
+			if (x.obj && x.t.advance(now) == AlertAdvance::Finished) x.obj = nullptr;
+		alertNextWakeMs(slots, 4, now);
+	}
+	for (Slot& x : slots)
+		if (x.obj) while (x.t.advance(now += 100) != AlertAdvance::Finished) {}
+	TEST_ASSERT_EQUAL(0, allocations);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_single_cycle_steps_and_expiry);
+	RUN_TEST(test_late_tick_catches_up_on_absolute_boundaries);
+	RUN_TEST(test_multi_cycle_count);
+	RUN_TEST(test_tick_wraparound);
+	RUN_TEST(test_slot_allocation);
+	RUN_TEST(test_next_wake);
+	RUN_TEST(test_flashing_does_not_allocate);
+	return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <string>
+#include "fs/atomicFile.h"
+#include "fs/fsCompat.h"
+
+// Power-cut tests for atomicWriteFile/atomicReadFile on the stub FS (test/stubs/FS.h):
+// the write is cut after every possible number of committed steps, then the file is
+// read back after a "reboot" and must hold either the old or the new content.
+
+static const char* PATH = "/s/session.json";
+
+void setUp() { fs::faults.format(); }
+void tearDown() {}
+
+static std::string readBack() {
+	char buf[256];
+	const int n = atomicReadFile(PATH, buf, sizeof(buf));
+	return n < 0 ? std::string("<none>") : std::string(buf, n);
+}
+
+static bool writeStr(const std::string& s) { return atomicWriteFile(PATH, s.data(), s.size()); }
+
+// Steps a complete write takes from the current state (-1 if it fails)
+static int stepsFor(const std::string& s) {
+	const auto saved = fs::faults.files;
+	const int before = fs::faults.steps;
+	const bool ok = writeStr(s);
+	const int n = fs::faults.steps - before;
+	fs::faults.files = saved;
+	return ok ? n : -1;
+}
+
+// Cut power after 0..n steps of writing 'next' over the current state
+static void cutEveryStep(const std::string& prev, const std::string& next) {
+	const auto base = fs::faults.files;
+	const int steps = stepsFor(next);
+	TEST_ASSERT_TRUE(steps >= 3);	// .tmp commit, rename to .bak, rename into place
+
+	for (int k = 0; k <= steps; ++k) {
+		fs::faults.files = base;
+		fs::faults.stepsLeft = k;
+		const bool ok = writeStr(next);
+		fs::faults.reboot();
+
+		const std::string got = readBack();
+		char msg[64];
+		snprintf(msg, sizeof(msg), "cut after %d of %d steps", k, steps);
+		TEST_ASSERT_TRUE_MESSAGE(got == prev || got == next, msg);
+		if (ok) TEST_ASSERT_EQUAL_STRING_MESSAGE(next.c_str(), got.c_str(), msg);
+		if (k == steps) TEST_ASSERT_TRUE_MESSAGE(ok, msg);
+
+		// whatever survived, the next write must win over it
+		TEST_ASSERT_TRUE_MESSAGE(writeStr("{\"after\":1}"), msg);
+		TEST_ASSERT_EQUAL_STRING_MESSAGE("{\"after\":1}", readBack().c_str(), msg);
+	}
+}
+
+static void test_roundtrip() {
+	TEST_ASSERT_EQUAL_STRING("<none>", readBack().c_str());
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	TEST_ASSERT_EQUAL_STRING("{\"a\":1}", readBack().c_str());
+	TEST_ASSERT_TRUE(writeStr("{\"a\":2}"));
+	TEST_ASSERT_EQUAL_STRING("{\"a\":2}", readBack().c_str());
+}
+
+static void test_power_cut_first_write() {
+	cutEveryStep("<none>", "{\"a\":1}");
+}
+
+static void test_power_cut_replace() {
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	cutEveryStep("{\"a\":1}", "{\"a\":22}");
+}
+
+static void test_power_cut_with_backup() {
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	TEST_ASSERT_TRUE(writeStr("{\"a\":2}"));	// .bak now exists and gets replaced
+	cutEveryStep("{\"a\":2}", "{\"a\":333}");
+}
+
+// Power cut between the two renames, twice in a row: <path> is missing both times
+static void test_repeated_cut_between_renames() {
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	const int steps = stepsFor("{\"a\":2}");
+	TEST_ASSERT_TRUE(steps >= 3);
+	fs::faults.stepsLeft = steps - 1;
+	TEST_ASSERT_FALSE(writeStr("{\"a\":2}"));
+	fs::faults.reboot();
+	TEST_ASSERT_FALSE(fs::faults.files.count(PATH));
+	TEST_ASSERT_EQUAL_STRING("{\"a\":2}", readBack().c_str());
+
+	fs::faults.stepsLeft = 1;	// .tmp commits, nothing else
+	TEST_ASSERT_FALSE(writeStr("{\"a\":3}"));
+	fs::faults.reboot();
+	TEST_ASSERT_EQUAL_STRING("{\"a\":3}", readBack().c_str());
+
+	TEST_ASSERT_TRUE(writeStr("{\"a\":4}"));
+	TEST_ASSERT_EQUAL_STRING("{\"a\":4}", readBack().c_str());
+}
+
+static void test_corrupt_copy_is_ignored() {
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	TEST_ASSERT_TRUE(writeStr("{\"a\":2}"));
+	std::string& cur = fs::faults.files[PATH];
+	cur[cur.size() - 2] ^= 0x01;	// payload no longer matches its CRC
+	TEST_ASSERT_EQUAL_STRING("{\"a\":1}", readBack().c_str());
+
+	fs::faults.files[std::string(PATH) + ".tmp"] = "#NC1 garbage";
+	TEST_ASSERT_EQUAL_STRING("{\"a\":1}", readBack().c_str());
+}
+
+static void test_legacy_file_without_header() {
+	fs::faults.files[PATH] = "{\"legacy\":true}";
+	TEST_ASSERT_EQUAL_STRING("{\"legacy\":true}", readBack().c_str());
+	TEST_ASSERT_TRUE(writeStr("{\"a\":1}"));
+	TEST_ASSERT_EQUAL_STRING("{\"a\":1}", readBack().c_str());
+}
+
+int main() {
+	UNITY_BEGIN();
+	RUN_TEST(test_roundtrip);
+	RUN_TEST(test_power_cut_first_write);
+	RUN_TEST(test_power_cut_replace);
+	RUN_TEST(test_power_cut_with_backup);
+	RUN_TEST(test_repeated_cut_between_renames);
+	RUN_TEST(test_corrupt_copy_is_ignored);
+	RUN_TEST(test_legacy_file_without_header);
+	return UNITY_END();
+}
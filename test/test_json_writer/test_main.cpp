@@ -0,0 +1,72 @@
+#include <unity.h>
+#include "fs/jsonWriter.h"
+
+static char buf[256];
+
+void setUp() { memset(buf, 0x55, sizeof(buf)); }
+void tearDown() {}
+
+static void test_nesting_and_commas() {
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject().field("ok", true).field("n", 3u).field("d", -7)
+	  .beginObject("counts").field("Api", 1u).field("Seconds", 2u).endObject()
+	  .beginArray("list").value(1).value("x").null().beginObject().endObject().endArray()
+	  .beginObject("empty").endObject()
+	  .endObject();
+	TEST_ASSERT_EQUAL_STRING(
+		"{\"ok\":true,\"n\":3,\"d\":-7,\"counts\":{\"Api\":1,\"Seconds\":2},"
+		"\"list\":[1,\"x\",null,{}],\"empty\":{}}", out.c_str());
+	TEST_ASSERT_EQUAL(out.length(), js.bytes());
+	TEST_ASSERT_FALSE(out.overflow());
+}
+
+static void test_string_escaping() {
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject().field("s", "a\"b\\c\nd\re\tf\x01g\x1f").field("k\"ey", "plain").endObject();
+	TEST_ASSERT_EQUAL_STRING(
+		"{\"s\":\"a\\\"b\\\\c\\nd\\re\\tf\\u0001g\\u001f\",\"k\\\"ey\":\"plain\"}", out.c_str());
+}
+
+static void test_utf8_and_null_strings_pass_through() {
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginArray().value("caf\xc3\xa9").value((const char*)nullptr).endArray();
+	TEST_ASSERT_EQUAL_STRING("[\"caf\xc3\xa9\",null]", out.c_str());
+}
+
+static void test_field1_formatting() {
+	BufferPrint out(buf, sizeof(buf));
+	JsonWriter js(out);
+	js.beginObject()
+	  .field1("a", 12.5f).field1("b", 0.0f).field1("c", 99.96f).field1("d", 0.04f)
+	  .field1("e", -1.25f).field1("f", -0.04f).field1("g", 100.0f)
+	  .endObject();
+	// tenths rounded half away from zero; -0.04 rounds to a plain 0.0
+	TEST_ASSERT_EQUAL_STRING(
+		"{\"a\":12.5,\"b\":0.0,\"c\":100.0,\"d\":0.0,\"e\":-1.3,\"f\":0.0,\"g\":100.0}", out.c_str());
+}
+
+static void test_buffer_truncates_and_flags() {
+	char small[8];
+	BufferPrint out(small, sizeof(small));
+	JsonWriter js(out);
+	js.beginObject().field("long", "abcdefgh").endObject();
+	TEST_ASSERT_TRUE(out.overflow());
+	TEST_ASSERT_EQUAL(7, out.length());
+	TEST_ASSERT_EQUAL_STRING("{\"long\"", small);	// always NUL-terminated
+	out.clear();
+	TEST_ASSERT_FALSE(out.overflow());
+	TEST_ASSERT_EQUAL_STRING("", small);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_nesting_and_commas);
+	RUN_TEST(test_string_escaping);
+	RUN_TEST(test_utf8_and_null_strings_pass_through);
+	RUN_TEST(test_field1_formatting);
+	RUN_TEST(test_buffer_truncates_and_flags);
+	return UNITY_END();
+}
@@ -0,0 +1,98 @@
+#include <unity.h>
+#include "dsp/nutClassifier.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Features whose vector is [2048 (log2 256 in Q8), rise, 4, 0, 0]
+static NutFeatures withRise(uint16_t rise) {
+	NutFeatures f = {};
+	f.peak = 256;
+	f.area = 4 * 256;
+	f.riseSamples = rise;
+	return f;
+}
+
+// Centroids differ only in rise (0, 10, 100, 200); unit weights, so distance = rise diff^2
+static const NutCentroidModel riseModel = {
+	{
+		{ 2048,   0, 4, 0, 0 },
+		{ 2048,  10, 4, 0, 0 },
+		{ 2048, 100, 4, 0, 0 },
+		{ 2048, 200, 4, 0, 0 },
+	},
+	{ 256, 256, 256, 256, 256 },
+	10000,
+};
+
+static void test_feature_vector() {
+	int32_t v[NUT_FEATURE_DIMS];
+	NutFeatures f = withRise(7);
+	f.decaySlopeQ15 = -960;
+	f.zeroCrossings = 3;
+	nutFeatureVector(f, v);
+	TEST_ASSERT_EQUAL(2048, v[0]);
+	TEST_ASSERT_EQUAL(7, v[1]);
+	TEST_ASSERT_EQUAL(4, v[2]);
+	TEST_ASSERT_EQUAL(-60, v[3]);
+	TEST_ASSERT_EQUAL(3, v[4]);
+}
+
+static void test_exact_match_is_certain() {
+	const ClassifyResult r = CentroidClassifier(riseModel).classify(withRise(10));
+	TEST_ASSERT_TRUE(r.cls == NutClass::Seconds);
+	TEST_ASSERT_TRUE(r.best == NutClass::Seconds);
+	TEST_ASSERT_EQUAL(255, r.confidence);
+}
+
+static void test_tie_is_unknown() {
+	const ClassifyResult r = CentroidClassifier(riseModel).classify(withRise(5));	// 25 vs 25
+	TEST_ASSERT_EQUAL(0, r.confidence);
+	TEST_ASSERT_TRUE(r.cls == NutClass::Unknown);
+	TEST_ASSERT_TRUE(r.best == NutClass::Api);		// nearest is still reported
+}
+
+static void test_min_confidence_gates_at_the_boundary() {
+	// rise 4: 16 vs 36 -> confidence 20 * 255 / 52 = 98
+	const NutFeatures f = withRise(4);
+	ClassifyResult r = CentroidClassifier(riseModel, 98).classify(f);
+	TEST_ASSERT_EQUAL(98, r.confidence);
+	TEST_ASSERT_TRUE(r.cls == NutClass::Api);
+	r = CentroidClassifier(riseModel, 99).classify(f);
+	TEST_ASSERT_TRUE(r.cls == NutClass::Unknown);
+	TEST_ASSERT_TRUE(r.best == NutClass::Api);
+}
+
+static void test_far_from_every_centroid_is_unknown() {
+	// rise 301: 101^2 to Mangala, 201^2 to Rashi -> confident, but past maxDistance (100^2)
+	const ClassifyResult r = CentroidClassifier(riseModel).classify(withRise(301));
+	TEST_ASSERT_TRUE(r.confidence >= NUT_CLASSIFY_MIN_CONF);
+	TEST_ASSERT_TRUE(r.cls == NutClass::Unknown);
+	TEST_ASSERT_TRUE(r.best == NutClass::Mangala);
+	// exactly at the limit still counts
+	TEST_ASSERT_TRUE(CentroidClassifier(riseModel).classify(withRise(300)).cls == NutClass::Mangala);
+}
+
+static void test_default_model_recognises_its_centroids() {
+	// Api centroid: log2 peak 4403 Q8 (peak 307 << 9), rise 6, width 40, slope -60, 8 crossings
+	NutFeatures f = {};
+	f.peak = 307 << 9;
+	f.area = 40ull * (uint32_t)f.peak;
+	f.riseSamples = 6;
+	f.decaySlopeQ15 = -60 * 16;
+	f.zeroCrossings = 8;
+	const ClassifyResult r = CentroidClassifier(kNutDefaultModel).classify(f);
+	TEST_ASSERT_TRUE(r.cls == NutClass::Api);
+	TEST_ASSERT_EQUAL(255, r.confidence);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_feature_vector);
+	RUN_TEST(test_exact_match_is_certain);
+	RUN_TEST(test_tie_is_unknown);
+	RUN_TEST(test_min_confidence_gates_at_the_boundary);
+	RUN_TEST(test_far_from_every_centroid_is_unknown);
+	RUN_TEST(test_default_model_recognises_its_centroids);
+	return UNITY_END();
+}
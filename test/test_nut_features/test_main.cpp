@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "dsp/nutFeatures.h"
+
+// Needs -D NUT_FEATURES_REFERENCE (set for env:native in platformio.ini)
+
+static NutWindow w;
+static uint32_t rng = 1;
+
+static int32_t noise(int32_t amp) {
+	rng = rng * 1664525u + 1013904223u;
+	return (int32_t)((rng >> 8) % (2u * amp + 1)) - amp;
+}
+
+void setUp() { w = NutWindow{}; rng = 1; }
+void tearDown() {}
+
+static void checkAgainstReference(const char* what) {
+	NutFeatures f;
+	NutFeaturesRef r;
+	nutFeaturesExtract(w, f);
+	nutFeaturesReference(w, r);
+	char msg[160];
+	snprintf(msg, sizeof(msg), "%s: peak %d/%.0f idx %u/%d slope %d/%.1f zc %u/%d", what,
+		(int)f.peak, r.peak, f.peakIdx, r.peakIdx, f.decaySlopeQ15, r.decaySlope * 32768.0,
+		f.zeroCrossings, r.zeroCrossings);
+	TEST_ASSERT_TRUE_MESSAGE(nutFeaturesMatchReference(f, r), msg);
+}
+
+// Ringing crack: exponentially decaying sine on a baseline, plus ADC noise
+static void fillRinging(uint16_t count, int32_t amp, double tau, double period, int32_t noiseAmp) {
+	w.baseline   = 120000;
+	w.count      = count;
+	w.triggerIdx = 64;
+	for (uint16_t i = 0; i < count; ++i) {
+		double d = 0.0;
+		if (i >= w.triggerIdx) {
+			const double k = i - w.triggerIdx;
+			d = amp * exp(-k / tau) * sin(2.0 * M_PI * k / period + 0.3);
+		}
+		w.samples[i] = w.baseline + (int32_t)d + noise(noiseAmp);
+	}
+}
+
+static void test_ringing_windows_match_reference() {
+	const double taus[]    = { 20.0, 80.0, 300.0 };
+	const double periods[] = { 7.0, 23.0, 61.0 };
+	for (double tau : taus)
+		for (double period : periods) {
+			fillRinging(1024, 2000000, tau, period, 500);
+			checkAgainstReference("ringing");
+		}
+}
+
+static void test_near_full_scale_does_not_overflow() {
+	fillRinging(1024, 8000000, 400.0, 50.0, 2000);
+	w.baseline = 0;
+	checkAgainstReference("full scale");
+	NutFeatures f;
+	nutFeaturesExtract(w, f);
+	TEST_ASSERT_TRUE(f.decaySlopeQ15 < 0);
+}
+
+// Peak followed by a short linear tail: exercises the slope at small N
+static void fillShortTail(uint16_t tail, int32_t peak, int32_t stepPerSample) {
+	w.baseline   = -5000;
+	w.triggerIdx = 10;
+	w.count      = 40 + 1 + tail;
+	for (uint16_t i = 0; i < 40; ++i) w.samples[i] = w.baseline + (int32_t)i * (peak / 41);
+	w.samples[40] = w.baseline + peak;
+	for (uint16_t k = 1; k <= tail; ++k) w.samples[40 + k] = w.baseline + peak + stepPerSample * k;
+}
+
+static void test_short_tail_slope_keeps_precision() {
+	// -1 % of peak per sample over 5 samples: Q15 slope -327.68
+	fillShortTail(5, 10000, -100);
+	NutFeatures f;
+	nutFeaturesExtract(w, f);
+	TEST_ASSERT_INT_WITHIN(1, -328, f.decaySlopeQ15);
+	checkAgainstReference("tail 5");
+
+	const int32_t steps[] = { -3, -40, -250 };
+	for (uint16_t tail = 2; tail <= 8; ++tail) {
+		for (int32_t step : steps) {
+			fillShortTail(tail, 9000, step);
+			checkAgainstReference("short tail");
+		}
+	}
+}
+
+static void test_truncated_window() {
+	// still rising when the window filled up: the peak is the last sample, no tail at all
+	w.baseline = 0; w.count = 300; w.triggerIdx = 20;
+	for (uint16_t i = 0; i < w.count; ++i) w.samples[i] = (int32_t)i * 1000 + noise(50);
+	NutFeatures f;
+	nutFeaturesExtract(w, f);
+	TEST_ASSERT_EQUAL(0, f.decaySlopeQ15);
+	checkAgainstReference("truncated");
+
+	w.samples[w.count - 3] = 400000;	// two-sample tail
+	checkAgainstReference("truncated, 2-sample tail");
+}
+
+static void test_random_windows_match_reference() {
+	for (uint32_t seed = 1; seed <= 200; ++seed) {
+		rng = seed;
+		const uint16_t count = 3 + (uint16_t)((seed * 37u) % (NUT_WINDOW_MAX - 3));
+		w.baseline = noise(100000); w.count = count; w.triggerIdx = count / 4;
+		for (uint16_t i = 0; i < count; ++i) w.samples[i] = w.baseline + noise(3000000);
+		checkAgainstReference("random");
+	}
+}
+
+// Host timing only (ns per sample); on the device the pipeline reports cycles per sample
+// (nutPipelineGetStats().featureCyclesPerSample)
+static void test_benchmark_ns_per_sample() {
+	fillRinging(1024, 2000000, 80.0, 23.0, 500);
+	NutFeatures f;
+	const int iters = 2000;
+	const auto t0 = std::chrono::steady_clock::now();
+	int64_t sink = 0;
+	for (int i = 0; i < iters; ++i) { nutFeaturesExtract(w, f); sink += f.decaySlopeQ15; }
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+	char msg[96];
+	snprintf(msg, sizeof(msg), "nutFeaturesExtract: %.2f ns/sample on the host (%lld)",
+		ns / iters / w.count, (long long)(sink & 1));
+	TEST_MESSAGE(msg);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_ringing_windows_match_reference);
+	RUN_TEST(test_near_full_scale_does_not_overflow);
+	RUN_TEST(test_short_tail_slope_keeps_precision);
+	RUN_TEST(test_truncated_window);
+	RUN_TEST(test_random_windows_match_reference);
+	RUN_TEST(test_benchmark_ns_per_sample);
+	return UNITY_END();
+}
@@ -0,0 +1,115 @@
+#include <unity.h>
+#include "dsp/nutSegmenter.h"
+
+static const int32_t BASE = 100;
+static const uint32_t DT = 500;		// 2 kSPS
+
+static NutSegmenter seg;
+static uint32_t t;
+
+static NutSegmenterConfig smallConfig() {
+	NutSegmenterConfig c;
+	c.threshold     = 1000;
+	c.releaseLevel  = 500;
+	c.preTrigger    = 8;
+	c.postTrigger   = 10;
+	c.holdOff       = 5;
+	c.baselineShift = 4;		// 16 warm-up samples
+	return c;
+}
+
+// Feed 'n' copies of 'code'; returns how many of them completed a window
+static int feed(int32_t code, uint32_t n) {
+	int done = 0;
+	for (uint32_t i = 0; i < n; ++i) { if (seg.push(t, code)) done++; t += DT; }
+	return done;
+}
+
+void setUp() {
+	seg.begin(smallConfig());
+	t = 1000;
+	feed(BASE, 40);		// warm up and settle on the baseline
+}
+void tearDown() {}
+
+static void test_quiet_input_never_triggers() {
+	TEST_ASSERT_EQUAL(0, feed(BASE + 999, 1));		// just under the threshold
+	TEST_ASSERT_EQUAL(0, feed(BASE, 1000));
+	TEST_ASSERT_FALSE(seg.inWindow());
+	TEST_ASSERT_EQUAL_UINT32(0, seg.windowsEmitted());
+}
+
+static void test_window_has_pre_trigger_and_post_trigger() {
+	const uint32_t tTrigger = t;
+	TEST_ASSERT_EQUAL(0, feed(BASE + 5000, 5));
+	TEST_ASSERT_TRUE(seg.inWindow());
+	TEST_ASSERT_EQUAL(0, feed(BASE, 9));			// one quiet sample short of closing
+	TEST_ASSERT_EQUAL(1, feed(BASE, 1));
+
+	const NutWindow& w = seg.window();
+	TEST_ASSERT_EQUAL(8 + 5 + 10, w.count);
+	TEST_ASSERT_EQUAL(8, w.triggerIdx);
+	TEST_ASSERT_EQUAL(BASE, w.baseline);
+	TEST_ASSERT_FALSE(w.truncated);
+	TEST_ASSERT_EQUAL_UINT32(tTrigger - 8 * DT, w.tStartUs);	// oldest pre-trigger sample
+	TEST_ASSERT_EQUAL_UINT32(DT, w.periodUs());
+	for (int i = 0; i < 8; ++i) TEST_ASSERT_EQUAL(BASE, w.samples[i]);
+	for (int i = 8; i < 13; ++i) TEST_ASSERT_EQUAL(BASE + 5000, w.samples[i]);
+	TEST_ASSERT_EQUAL_UINT32(1, seg.windowsEmitted());
+}
+
+static void test_loud_sample_resets_the_quiet_run() {
+	feed(BASE - 5000, 1);							// negative swings trigger too
+	feed(BASE, 9);
+	feed(BASE + 600, 1);							// above releaseLevel: not quiet
+	TEST_ASSERT_EQUAL(0, feed(BASE, 9));
+	TEST_ASSERT_EQUAL(1, feed(BASE, 1));
+	TEST_ASSERT_EQUAL(8 + 1 + 9 + 1 + 10, seg.window().count);
+}
+
+static void test_hold_off_and_no_history_leak() {
+	feed(BASE + 5000, 1);
+	TEST_ASSERT_EQUAL(1, feed(BASE, 10));
+	TEST_ASSERT_EQUAL(0, feed(BASE + 5000, 1));		// inside the hold-off: ignored
+	TEST_ASSERT_FALSE(seg.inWindow());
+	feed(BASE, 4);									// hold-off over after 5 samples
+	feed(BASE, 2);
+	feed(BASE + 5000, 1);
+	TEST_ASSERT_TRUE(seg.inWindow());
+	TEST_ASSERT_EQUAL(1, feed(BASE, 10));
+	// only the 7 samples seen since the last window can be pre-trigger history
+	TEST_ASSERT_EQUAL(7, seg.window().triggerIdx);
+	TEST_ASSERT_EQUAL(7 + 1 + 10, seg.window().count);
+}
+
+static void test_window_truncates_when_full() {
+	TEST_ASSERT_EQUAL(0, feed(BASE + 5000, NUT_WINDOW_MAX - 8 - 1));
+	TEST_ASSERT_EQUAL(1, feed(BASE + 5000, 1));
+	const NutWindow& w = seg.window();
+	TEST_ASSERT_EQUAL(NUT_WINDOW_MAX, w.count);
+	TEST_ASSERT_TRUE(w.truncated);
+	TEST_ASSERT_EQUAL_UINT32(1, seg.windowsTruncated());
+	TEST_ASSERT_FALSE(seg.inWindow());
+}
+
+static void test_config_is_clamped() {
+	NutSegmenterConfig c = smallConfig();
+	c.preTrigger = NUT_PRE_MAX + 50;
+	c.releaseLevel = c.threshold * 2;
+	seg.begin(c);
+	TEST_ASSERT_EQUAL(NUT_PRE_MAX, seg.config().preTrigger);
+	TEST_ASSERT_EQUAL(c.threshold, seg.config().releaseLevel);
+	// 2 kSPS, shortest nut 8 + 1 + 10 + 5 samples
+	TEST_ASSERT_EQUAL_UINT32(60u * 2000u / 24u, smallConfig().maxNutsPerMinute(2000));
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_quiet_input_never_triggers);
+	RUN_TEST(test_window_has_pre_trigger_and_post_trigger);
+	RUN_TEST(test_loud_sample_resets_the_quiet_run);
+	RUN_TEST(test_hold_off_and_no_history_leak);
+	RUN_TEST(test_window_truncates_when_full);
+	RUN_TEST(test_config_is_clamped);
+	return UNITY_END();
+}
@@ -0,0 +1,96 @@
+#include <unity.h>
+#include "acq/sampleRing.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_empty_ring() {
+	SampleRing<int, 4> r;
+	int v = -1;
+	TEST_ASSERT_TRUE(r.empty());
+	TEST_ASSERT_FALSE(r.pop(v));
+	TEST_ASSERT_EQUAL(-1, v);
+	TEST_ASSERT_EQUAL(0, r.popBulk(&v, 1));
+	TEST_ASSERT_EQUAL(0, r.overflows());
+	TEST_ASSERT_EQUAL(0, r.highWater());
+}
+
+static void test_full_edge_and_overflow_count() {
+	SampleRing<int, 4> r;
+	for (int i = 0; i < 4; ++i) TEST_ASSERT_TRUE(r.push(i));
+	TEST_ASSERT_EQUAL(4, r.size());
+	TEST_ASSERT_FALSE(r.push(99));
+	TEST_ASSERT_FALSE(r.push(100));
+	TEST_ASSERT_EQUAL(2, r.overflows());
+
+	// rejected pushes must not have touched the stored items
+	int v;
+	for (int i = 0; i < 4; ++i) { TEST_ASSERT_TRUE(r.pop(v)); TEST_ASSERT_EQUAL(i, v); }
+	TEST_ASSERT_TRUE(r.empty());
+	TEST_ASSERT_TRUE(r.push(5));	// room again after draining
+	TEST_ASSERT_EQUAL(2, r.overflows());
+}
+
+static void test_wraparound_keeps_fifo_order() {
+	SampleRing<int, 8> r;
+	int next = 0, expect = 0, v;
+	// odd push/pop strides walk the indices around the buffer many times
+	for (int round = 0; round < 1000; ++round) {
+		for (int k = 0; k < 5; ++k) TEST_ASSERT_TRUE(r.push(next++));
+		for (int k = 0; k < 5; ++k) { TEST_ASSERT_TRUE(r.pop(v)); TEST_ASSERT_EQUAL(expect++, v); }
+	}
+	TEST_ASSERT_TRUE(r.empty());
+	TEST_ASSERT_EQUAL(0, r.overflows());
+}
+
+static void test_pop_bulk_across_the_wrap() {
+	SampleRing<int, 8> r;
+	int v, out[8];
+	for (int i = 0; i < 6; ++i) r.push(i);
+	for (int i = 0; i < 6; ++i) r.pop(v);
+	for (int i = 0; i < 8; ++i) TEST_ASSERT_TRUE(r.push(100 + i));	// indices 6..13: crosses the end
+
+	TEST_ASSERT_EQUAL(3, r.popBulk(out, 3));
+	for (int i = 0; i < 3; ++i) TEST_ASSERT_EQUAL(100 + i, out[i]);
+	TEST_ASSERT_EQUAL(5, r.popBulk(out, 8));	// asks for more than is queued
+	for (int i = 0; i < 5; ++i) TEST_ASSERT_EQUAL(103 + i, out[i]);
+	TEST_ASSERT_TRUE(r.empty());
+}
+
+static void test_repeated_full_cycles() {
+	// smallest ring, filled to the edge and drained every pass: head - tail hits N each time
+	SampleRing<uint8_t, 2> r;
+	uint8_t v;
+	for (uint32_t i = 0; i < 100000; ++i) {
+		TEST_ASSERT_TRUE(r.push((uint8_t)i));
+		TEST_ASSERT_TRUE(r.push((uint8_t)(i + 1)));
+		TEST_ASSERT_FALSE(r.push(0));
+		TEST_ASSERT_TRUE(r.pop(v)); TEST_ASSERT_EQUAL((uint8_t)i, v);
+		TEST_ASSERT_TRUE(r.pop(v)); TEST_ASSERT_EQUAL((uint8_t)(i + 1), v);
+	}
+	TEST_ASSERT_EQUAL(100000, r.overflows());
+}
+
+static void test_high_water_mark() {
+	SampleRing<int, 16> r;
+	int v;
+	for (int i = 0; i < 3; ++i) r.push(i);
+	TEST_ASSERT_EQUAL(3, r.highWater());
+	for (int i = 0; i < 3; ++i) r.pop(v);
+	r.push(1);
+	TEST_ASSERT_EQUAL(3, r.highWater());	// a mark, not the current fill
+	for (int i = 0; i < 20; ++i) r.push(i);
+	TEST_ASSERT_EQUAL(16, r.highWater());	// capped at the capacity
+	TEST_ASSERT_EQUAL(16, r.capacity());
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_empty_ring);
+	RUN_TEST(test_full_edge_and_overflow_count);
+	RUN_TEST(test_wraparound_keeps_fifo_order);
+	RUN_TEST(test_pop_bulk_across_the_wrap);
+	RUN_TEST(test_repeated_full_cycles);
+	RUN_TEST(test_high_water_mark);
+	return UNITY_END();
+}
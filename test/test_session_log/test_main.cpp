@@ -0,0 +1,157 @@
+#include <unity.h>
+#include "app/sessionLog.h"
+#include "fs/fsCompat.h"
+
+static const char* LOG = "/s/nuts.bin";
+
+void setUp() { fs::faults.format(); }
+void tearDown() {}
+
+// A ramp around 'base' whose peak needs a sample shift when 'big' is set
+static void makeCodes(int32_t* codes, uint16_t n, int32_t base, bool big) {
+	for (uint16_t i = 0; i < n; ++i) codes[i] = base + (big ? (int32_t)i * 997 : (int32_t)i - n / 2);
+}
+
+static uint32_t appendOne(SessionLog& log, uint32_t index, uint16_t n, bool big = false) {
+	static int32_t codes[600];
+	makeCodes(codes, n, 1000, big);
+	NutRecordHeader h = {};
+	h.index = index;
+	h.baseline = 1000;
+	h.predClass = 1;
+	return log.append(h, codes, n);
+}
+
+static void test_round_trip_across_a_chunk_boundary() {
+	SessionLog log;
+	TEST_ASSERT_TRUE(log.open(LOG));
+	uint32_t offs[10];
+	for (uint32_t i = 0; i < 10; ++i) {
+		offs[i] = appendOne(log, i + 1, 300, i == 7);	// 632 B each: the 7th crosses 4096
+		TEST_ASSERT_TRUE(offs[i] != 0);
+	}
+	// one whole chunk reached flash, the rest is staged
+	TEST_ASSERT_EQUAL_UINT32(SESSION_LOG_CHUNK, fs::faults.files[LOG].size());
+	TEST_ASSERT_EQUAL_UINT32(16 + 10 * 632 - SESSION_LOG_CHUNK, log.staged());
+	TEST_ASSERT_TRUE(log.sync());
+	TEST_ASSERT_EQUAL_UINT32(log.size(), fs::faults.files[LOG].size());
+
+	SessionLogReader rd;
+	TEST_ASSERT_TRUE(rd.open(LOG));
+	NutRecordHeader h;
+	int16_t s[300];
+	int32_t codes[300];
+	for (uint32_t i = 0; i < 10; ++i) {
+		uint32_t off = 0;
+		TEST_ASSERT_TRUE(rd.next(h, s, 300, &off));
+		TEST_ASSERT_EQUAL_UINT32(offs[i], off);
+		TEST_ASSERT_EQUAL_UINT32(i + 1, h.index);
+		TEST_ASSERT_EQUAL(300, h.sampleCount);
+		TEST_ASSERT_EQUAL(NUT_OVERRIDE_NONE, h.overrideClass);
+		TEST_ASSERT_EQUAL(i == 7 ? 4 : 0, h.sampleShift);	// 299 * 997 needs >> 4 to fit int16
+		makeCodes(codes, 300, 1000, i == 7);
+		for (int k = 0; k < 300; ++k) TEST_ASSERT_EQUAL((codes[k] - 1000) >> h.sampleShift, s[k]);
+	}
+	TEST_ASSERT_FALSE(rd.next(h, nullptr, 0));
+	TEST_ASSERT_FALSE(rd.corrupt());
+	rd.close();
+}
+
+static void test_override_patch_keeps_the_crc() {
+	SessionLog log;
+	TEST_ASSERT_TRUE(log.open(LOG));
+	const uint32_t onFlash = appendOne(log, 1, 600);
+	for (uint32_t i = 2; i <= 8; ++i) appendOne(log, i, 300);	// push record 1 out to flash
+	const uint32_t staged = appendOne(log, 9, 20);
+	TEST_ASSERT_TRUE(staged >= fs::faults.files[LOG].size());
+
+	TEST_ASSERT_TRUE(log.patchOverride(onFlash, 3));	// in place on flash
+	TEST_ASSERT_TRUE(log.patchOverride(staged, 2));	// in RAM
+	TEST_ASSERT_TRUE(log.bytesWritten() > SESSION_LOG_CHUNK);	// the flash patch rewrote the tail
+	TEST_ASSERT_FALSE(log.patchOverride(log.size(), 1));	// past the end
+
+	NutRecordHeader h;
+	TEST_ASSERT_TRUE(log.readHeader(onFlash, h));
+	TEST_ASSERT_EQUAL(3, h.overrideClass);
+	TEST_ASSERT_TRUE(log.readHeader(staged, h));
+	TEST_ASSERT_EQUAL(2, h.overrideClass);
+	TEST_ASSERT_TRUE(log.sync());
+
+	SessionLogReader rd;
+	TEST_ASSERT_TRUE(rd.open(LOG));
+	uint32_t n = 0, off = 0;
+	while (rd.next(h, nullptr, 0, &off)) {
+		n++;
+		if (off == onFlash) TEST_ASSERT_EQUAL(3, h.overrideClass);
+		else if (off == staged) TEST_ASSERT_EQUAL(2, h.overrideClass);
+		else TEST_ASSERT_EQUAL(NUT_OVERRIDE_NONE, h.overrideClass);
+	}
+	TEST_ASSERT_EQUAL_UINT32(9, n);			// every record still passes its CRC
+	TEST_ASSERT_FALSE(rd.corrupt());
+	rd.close();
+}
+
+static void test_corrupt_record_is_skipped() {
+	SessionLog log;
+	TEST_ASSERT_TRUE(log.open(LOG));
+	appendOne(log, 1, 50);
+	const uint32_t bad = appendOne(log, 2, 50);
+	appendOne(log, 3, 50);
+	TEST_ASSERT_TRUE(log.sync());
+	fs::faults.files[LOG][bad + sizeof(NutRecordHeader) + 10] ^= 0x40;	// flip a sample bit
+
+	SessionLogReader rd;
+	TEST_ASSERT_TRUE(rd.open(LOG));
+	NutRecordHeader h;
+	TEST_ASSERT_TRUE(rd.next(h, nullptr, 0));
+	TEST_ASSERT_EQUAL_UINT32(1, h.index);
+	TEST_ASSERT_TRUE(rd.next(h, nullptr, 0));
+	TEST_ASSERT_EQUAL_UINT32(3, h.index);		// record 2 failed its CRC and was skipped
+	TEST_ASSERT_TRUE(rd.corrupt());
+	TEST_ASSERT_FALSE(rd.next(h, nullptr, 0));
+	rd.close();
+}
+
+static void test_failed_write_marks_the_log_failed() {
+	SessionLog log;
+	TEST_ASSERT_TRUE(log.open(LOG));
+	appendOne(log, 1, 50);
+	TEST_ASSERT_TRUE(log.sync());
+	const uint32_t before = log.size();
+
+	fs::faults.spaceLeft = 100;			// flash fills up in the middle of the next chunk
+	TEST_ASSERT_TRUE(appendOne(log, 2, 50) != 0);	// staged only
+	TEST_ASSERT_FALSE(log.sync());			// short write
+	TEST_ASSERT_TRUE(log.failed());
+	TEST_ASSERT_EQUAL_UINT32(0, appendOne(log, 3, 50));
+	TEST_ASSERT_EQUAL_UINT32(0, appendOne(log, 4, 50));
+	TEST_ASSERT_EQUAL_UINT32(2, log.droppedRecords());
+	TEST_ASSERT_EQUAL_UINT32(before, log.size() - log.staged());	// nothing counted as flushed
+
+	// a failed write partway through a chunk also refuses the record being staged
+	fs::faults.reboot();
+	fs::faults.format();
+	SessionLog log2;
+	TEST_ASSERT_TRUE(log2.open(LOG));
+	fs::faults.spaceLeft = 1000;
+	uint32_t i = 1;
+	while (appendOne(log2, i, 300)) i++;
+	TEST_ASSERT_TRUE(log2.failed());
+	TEST_ASSERT_EQUAL_UINT32(1, log2.droppedRecords());
+
+	// reopening starts over
+	fs::faults.reboot();
+	TEST_ASSERT_TRUE(log2.open("/s/other.bin"));
+	TEST_ASSERT_FALSE(log2.failed());
+	TEST_ASSERT_EQUAL_UINT32(0, log2.droppedRecords());
+	TEST_ASSERT_TRUE(appendOne(log2, 1, 50) != 0);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_round_trip_across_a_chunk_boundary);
+	RUN_TEST(test_override_patch_keeps_the_crc);
+	RUN_TEST(test_corrupt_record_is_skipped);
+	RUN_TEST(test_failed_write_marks_the_log_failed);
+	return UNITY_END();
+}
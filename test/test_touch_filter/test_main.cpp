@@ -0,0 +1,82 @@
+#include <unity.h>
+#include "UI/touchFilter.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_median3_every_order() {
+	const uint16_t v[3] = { 10, 20, 30 };
+	const int perm[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+	for (const auto& p : perm) TEST_ASSERT_EQUAL(20, median3(v[p[0]], v[p[1]], v[p[2]]));
+	TEST_ASSERT_EQUAL(7, median3(7, 7, 4000));		// a single spike is rejected
+	TEST_ASSERT_EQUAL(5, median3(5, 5, 5));
+	TEST_ASSERT_EQUAL(4095, median3(0, 4095, 4095));
+}
+
+static void test_map_axis() {
+	TEST_ASSERT_EQUAL(0,   mapAxis(200, 200, 3900, 240, false));
+	TEST_ASSERT_EQUAL(239, mapAxis(3900, 200, 3900, 240, false));
+	TEST_ASSERT_EQUAL(119, mapAxis(2050, 200, 3900, 240, false));	// mid-scale, rounded down
+	TEST_ASSERT_EQUAL(0,   mapAxis(0, 200, 3900, 240, false));		// outside the calibration: clamped
+	TEST_ASSERT_EQUAL(239, mapAxis(4095, 200, 3900, 240, false));
+	TEST_ASSERT_EQUAL(239, mapAxis(200, 200, 3900, 240, true));		// inverted
+	TEST_ASSERT_EQUAL(0,   mapAxis(4095, 200, 3900, 240, true));
+}
+
+static void test_press_needs_consecutive_samples() {
+	TouchFilter f(2, 3, 1);
+	int32_t x = -1, y = -1;
+	bool edge = true;
+	TEST_ASSERT_FALSE(f.touched(1000, 2000, x, y, &edge));		// 1 of 2
+	TEST_ASSERT_FALSE(edge);
+	TEST_ASSERT_FALSE(f.untouched());						// bounce: the run restarts
+	TEST_ASSERT_FALSE(f.touched(1000, 2000, x, y, &edge));
+	TEST_ASSERT_TRUE(f.touched(1000, 2000, x, y, &edge));
+	TEST_ASSERT_TRUE(edge);
+	TEST_ASSERT_TRUE(f.down());
+	TEST_ASSERT_EQUAL(1000, x);
+	TEST_ASSERT_EQUAL(2000, y);
+	TEST_ASSERT_TRUE(f.touched(1000, 2000, x, y, &edge));		// held: every pass reports
+	TEST_ASSERT_FALSE(edge);
+}
+
+static void test_release_needs_consecutive_samples() {
+	TouchFilter f(1, 3, 1);
+	int32_t x, y;
+	TEST_ASSERT_TRUE(f.touched(500, 500, x, y));
+	TEST_ASSERT_FALSE(f.untouched());
+	TEST_ASSERT_FALSE(f.untouched());
+	TEST_ASSERT_TRUE(f.touched(500, 500, x, y));				// contact back before release: the run restarts
+	TEST_ASSERT_FALSE(f.untouched());
+	TEST_ASSERT_FALSE(f.untouched());
+	TEST_ASSERT_TRUE(f.untouched());						// third in a row: release edge
+	TEST_ASSERT_FALSE(f.down());
+	TEST_ASSERT_FALSE(f.untouched());						// reported once
+}
+
+static void test_iir_smooths_and_resets_on_new_contact() {
+	TouchFilter f(1, 1, 1);
+	int32_t x, y;
+	TEST_ASSERT_TRUE(f.touched(1000, 1000, x, y));
+	TEST_ASSERT_EQUAL(1000, x);								// a new contact starts at its reading
+	TEST_ASSERT_TRUE(f.touched(2000, 3000, x, y));
+	TEST_ASSERT_EQUAL(1500, x);								// y += (x - y) >> 1
+	TEST_ASSERT_EQUAL(2000, y);
+	TEST_ASSERT_TRUE(f.touched(2000, 3000, x, y));
+	TEST_ASSERT_EQUAL(1750, x);
+
+	TEST_ASSERT_TRUE(f.untouched());
+	TEST_ASSERT_TRUE(f.touched(100, 200, x, y));				// no drag from the old position
+	TEST_ASSERT_EQUAL(100, x);
+	TEST_ASSERT_EQUAL(200, y);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_median3_every_order);
+	RUN_TEST(test_map_axis);
+	RUN_TEST(test_press_needs_consecutive_samples);
+	RUN_TEST(test_release_needs_consecutive_samples);
+	RUN_TEST(test_iir_smooths_and_resets_on_new_contact);
+	return UNITY_END();
+}
@@ -0,0 +1,146 @@
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "app/traceTap.h"
+
+// traceTap keeps its state in statics: the tests run in order and build on what the
+// earlier ones produced (live points are pushed in whole TRACE_LIVE_DECIM groups)
+
+static NutWindow win;
+static TraceEnvelope env;
+
+void setUp() {}
+void tearDown() {}
+
+// One live point whose samples span [v - 5, v + 5] and whose baseline is v
+static void livePoint(int32_t v) {
+	for (int i = 0; i < TRACE_LIVE_DECIM; ++i) traceTapSample(v + (i == 0 ? -5 : i == 1 ? 5 : 0), v);
+}
+
+static void test_live_partial_ring() {
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_EQUAL(0, env.points);
+	for (int i = 0; i < TRACE_LIVE_DECIM - 1; ++i) traceTapSample(1, 0);
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_EQUAL(0, env.points);			// a point needs TRACE_LIVE_DECIM samples
+	traceTapSample(50, 7);
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_EQUAL(1, env.points);
+	TEST_ASSERT_EQUAL(1, env.mn[0]);
+	TEST_ASSERT_EQUAL(50, env.mx[0]);
+	TEST_ASSERT_EQUAL(7, env.base[0]);
+	TEST_ASSERT_EQUAL(TRACE_LIVE_DECIM, env.perPoint);
+	TEST_ASSERT_EQUAL(1, env.lo);
+	TEST_ASSERT_EQUAL(50, env.hi);
+	TEST_ASSERT_FALSE(env.saturated);
+}
+
+static void test_live_ring_rotates_oldest_first() {
+	for (int32_t v = 1; v <= TRACE_POINTS + 5; ++v) livePoint(v * 100);
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_EQUAL(TRACE_POINTS, env.points);
+	for (int i = 0; i < TRACE_POINTS; ++i) {
+		const int32_t v = (6 + i) * 100;		// the first 5 (and the partial test's point) fell off
+		TEST_ASSERT_EQUAL(v - 5, env.mn[i]);
+		TEST_ASSERT_EQUAL(v + 5, env.mx[i]);
+		TEST_ASSERT_EQUAL(v, env.base[i]);
+	}
+	TEST_ASSERT_EQUAL(600 - 5, env.lo);
+	TEST_ASSERT_EQUAL((TRACE_POINTS + 5) * 100 + 5, env.hi);
+}
+
+static void test_live_saturation_flag() {
+	livePoint(TRACE_SAT_CODE + 10);
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_TRUE(env.saturated);
+	for (int i = 0; i < TRACE_POINTS; ++i) livePoint(0);	// pushed out again
+	TEST_ASSERT_TRUE(traceTapReadLive(env));
+	TEST_ASSERT_FALSE(env.saturated);
+}
+
+static void test_nut_window_folds_to_min_max() {
+	win.count = TRACE_POINTS * 2 + 10;			// 250 samples -> 3 per point, 84 points
+	win.baseline = 42;
+	win.triggerIdx = 31;
+	for (uint16_t i = 0; i < win.count; ++i) win.samples[i] = (i % 3 == 1) ? 1000 + i : -(int32_t)i;
+	traceTapWindow(win, NutClass::Rashi);
+
+	TEST_ASSERT_TRUE(traceTapReadNut(env));
+	TEST_ASSERT_EQUAL(3, env.perPoint);
+	TEST_ASSERT_EQUAL(84, env.points);
+	TEST_ASSERT_EQUAL(10, env.triggerPoint);
+	TEST_ASSERT_EQUAL((uint8_t)NutClass::Rashi, env.cls);
+	TEST_ASSERT_EQUAL(-2, env.mn[0]);
+	TEST_ASSERT_EQUAL(1001, env.mx[0]);
+	TEST_ASSERT_EQUAL(42, env.base[83]);
+	TEST_ASSERT_EQUAL(-249, env.mn[83]);		// last point holds the single leftover sample
+	TEST_ASSERT_EQUAL(-249, env.mx[83]);
+	TEST_ASSERT_EQUAL(-249, env.lo);
+	TEST_ASSERT_EQUAL(1000 + 247, env.hi);
+}
+
+static void test_notify_on_window() {
+	static std::atomic<int> calls{0};
+	traceTapSetNotify([] { calls++; });
+	const int before = calls;
+	traceTapWindow(win, NutClass::Api);			// windows notify at once
+	TEST_ASSERT_EQUAL(before + 1, (int)calls);
+	traceTapSetNotify(nullptr);
+	traceTapWindow(win, NutClass::Api);
+	TEST_ASSERT_EQUAL(before + 1, (int)calls);
+}
+
+// A producer rewriting both traces flat out while a reader copies them: every copy the
+// seqlock accepts must come from a single write (consecutive live points, one value per nut)
+static void test_seqlock_never_returns_a_torn_copy() {
+	std::atomic<bool> stop{false};
+	std::thread producer([&stop] {
+		static NutWindow w;
+		w.count = NUT_WINDOW_MAX;
+		w.triggerIdx = 0;
+		for (int32_t v = 1; !stop.load(std::memory_order_relaxed); ++v) {
+			livePoint(v * 16);
+			for (uint16_t i = 0; i < w.count; ++i) w.samples[i] = v;
+			w.baseline = v;
+			traceTapWindow(w, NutClass::Seconds);
+		}
+	});
+
+	const TraceTapStats s0 = traceTapGetStats();
+	uint32_t good = 0, badLive = 0, badNut = 0;
+	for (int n = 0; n < 20000; ++n) {
+		if (traceTapReadLive(env) && env.points == TRACE_POINTS) {
+			good++;
+			for (int i = 1; i < TRACE_POINTS; ++i)
+				if (env.base[i] != env.base[i - 1] + 16 && env.base[i - 1] > 0) { badLive++; break; }
+		}
+		// (until the producer's first window lands, this reads the earlier tests' Rashi/Api ones)
+		if (traceTapReadNut(env) && env.cls == (uint8_t)NutClass::Seconds) {
+			for (uint16_t i = 0; i < env.points; ++i)
+				if (env.mn[i] != env.base[0] || env.mx[i] != env.base[0]) { badNut++; break; }
+		}
+	}
+	stop = true;
+	producer.join();
+
+	const TraceTapStats s1 = traceTapGetStats();
+	char msg[96];
+	snprintf(msg, sizeof(msg), "seqlock: %u full live copies, %u reads gave up as torn",
+		(unsigned)good, (unsigned)(s1.torn - s0.torn));
+	TEST_MESSAGE(msg);
+	TEST_ASSERT_EQUAL_UINT32(0, badLive);
+	TEST_ASSERT_EQUAL_UINT32(0, badNut);
+	TEST_ASSERT_TRUE(good > 0);
+	TEST_ASSERT_EQUAL_UINT32(40000, s1.reads - s0.reads);
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_live_partial_ring);
+	RUN_TEST(test_live_ring_rotates_oldest_first);
+	RUN_TEST(test_live_saturation_flag);
+	RUN_TEST(test_nut_window_folds_to_min_max);
+	RUN_TEST(test_notify_on_window);
+	RUN_TEST(test_seqlock_never_returns_a_torn_copy);
+	return UNITY_END();
+}
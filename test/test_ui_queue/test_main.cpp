@@ -0,0 +1,117 @@
+#include <unity.h>
+#include <thread>
+#include <vector>
+#include "UI/uiQueue.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_empty_queue() {
+	MpscQueue<int, 4> q;
+	int v = -1;
+	TEST_ASSERT_FALSE(q.pop(v));
+	TEST_ASSERT_EQUAL(-1, v);
+	TEST_ASSERT_EQUAL(0, q.size());
+	TEST_ASSERT_EQUAL(4, q.capacity());
+}
+
+static void test_full_queue_fails_fast() {
+	MpscQueue<int, 4> q;
+	for (int i = 0; i < 4; ++i) TEST_ASSERT_TRUE(q.push(i));
+	TEST_ASSERT_EQUAL(4, q.size());
+	TEST_ASSERT_FALSE(q.push(99));
+
+	// the refused push must not have touched a queued item
+	int v;
+	TEST_ASSERT_TRUE(q.pop(v));
+	TEST_ASSERT_EQUAL(0, v);
+	TEST_ASSERT_TRUE(q.push(4));	// one slot freed, one slot taken
+	TEST_ASSERT_FALSE(q.push(5));
+	for (int i = 1; i <= 4; ++i) { TEST_ASSERT_TRUE(q.pop(v)); TEST_ASSERT_EQUAL(i, v); }
+	TEST_ASSERT_FALSE(q.pop(v));
+}
+
+static void test_wraparound_keeps_fifo_order() {
+	MpscQueue<int, 8> q;
+	int next = 0, expect = 0, v;
+	// odd strides walk the head and the cell sequence numbers through many laps
+	for (int round = 0; round < 1000; ++round) {
+		for (int k = 0; k < 5; ++k) TEST_ASSERT_TRUE(q.push(next++));
+		for (int k = 0; k < 5; ++k) { TEST_ASSERT_TRUE(q.pop(v)); TEST_ASSERT_EQUAL(expect++, v); }
+	}
+	TEST_ASSERT_EQUAL(0, q.size());
+}
+
+static void test_ui_command_payload_survives() {
+	MpscQueue<UiCommand, 4> q;
+	TEST_ASSERT_TRUE(q.push(UiCommand{ UiCmdType::UnknownPrompt, 0, NutRef{ 4096, 7 } }));
+	TEST_ASSERT_TRUE(q.push(UiCommand{ UiCmdType::Flash, (uint8_t)NutClass::Rashi, NutRef{} }));
+	UiCommand c;
+	TEST_ASSERT_TRUE(q.pop(c));
+	TEST_ASSERT_TRUE(c.type == UiCmdType::UnknownPrompt);
+	TEST_ASSERT_EQUAL_UINT32(4096, c.nut.recOffset);
+	TEST_ASSERT_EQUAL(7, c.nut.session);
+	TEST_ASSERT_TRUE(q.pop(c));
+	TEST_ASSERT_TRUE(c.type == UiCmdType::Flash);
+	TEST_ASSERT_EQUAL((uint8_t)NutClass::Rashi, c.arg);
+}
+
+static void test_coalescing_slot() {
+	CoalescingSlot s;
+	TEST_ASSERT_TRUE(s.post(1));		// first post queues a command
+	TEST_ASSERT_FALSE(s.post(2));		// later ones ride along with it
+	TEST_ASSERT_FALSE(s.post(3));
+	TEST_ASSERT_EQUAL_UINT32(3, s.take());	// the consumer sees the newest value
+	TEST_ASSERT_TRUE(s.post(4));		// taken: the next post queues again
+
+	s.cancel();							// the queue refused that command
+	TEST_ASSERT_TRUE(s.post(5));		// so the next post retries
+	TEST_ASSERT_EQUAL_UINT32(5, s.take());
+}
+
+// Several producers racing one consumer: nothing lost, nothing duplicated, and each
+// producer's items arrive in the order it pushed them
+static void test_multi_producer_stress() {
+	static const int PRODUCERS = 4;
+	static const uint32_t PER_PRODUCER = 50000;
+	MpscQueue<uint32_t, 32> q;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; ++p) {
+		producers.emplace_back([&q, p] {
+			for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+				const uint32_t v = (uint32_t)p << 24 | i;
+				while (!q.push(v)) std::this_thread::yield();	// full: wait for the consumer
+			}
+		});
+	}
+
+	uint32_t nextSeen[PRODUCERS] = {};
+	uint32_t received = 0, outOfOrder = 0, badProducer = 0;
+	uint32_t v;
+	while (received < PRODUCERS * PER_PRODUCER) {
+		if (!q.pop(v)) { std::this_thread::yield(); continue; }
+		const uint32_t p = v >> 24, i = v & 0xFFFFFF;
+		if (p >= (uint32_t)PRODUCERS) { badProducer++; received++; continue; }
+		if (i != nextSeen[p]) outOfOrder++;
+		nextSeen[p] = i + 1;
+		received++;
+	}
+	for (std::thread& t : producers) t.join();
+
+	TEST_ASSERT_EQUAL_UINT32(0, badProducer);
+	TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+	for (int p = 0; p < PRODUCERS; ++p) TEST_ASSERT_EQUAL_UINT32(PER_PRODUCER, nextSeen[p]);
+	TEST_ASSERT_FALSE(q.pop(v));
+	TEST_ASSERT_EQUAL(0, q.size());
+}
+
+int main(int, char**) {
+	UNITY_BEGIN();
+	RUN_TEST(test_empty_queue);
+	RUN_TEST(test_full_queue_fails_fast);
+	RUN_TEST(test_wraparound_keeps_fifo_order);
+	RUN_TEST(test_ui_command_payload_survives);
+	RUN_TEST(test_coalescing_slot);
+	RUN_TEST(test_multi_producer_stress);
+	return UNITY_END();
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Embed web/ assets into src/net/webAssets.h as gzip'd PROGMEM arrays.
+
+Runs as a PlatformIO pre-script (extra_scripts = pre:tools/embed_web.py) and can be
+run by hand. The output is deterministic (gzip mtime 0), so the header only changes
+when an asset does; the ETag is a hash of the uncompressed file.
+"""
+import gzip
+import hashlib
+import os
+import re
+
+ASSETS = [
+    # (file under web/, URL path, content type)
+    ("index.html", "/", "text/html"),
+]
+
+try:
+    Import("env")  # noqa: F821 (PlatformIO)
+    ROOT = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "src", "net", "webAssets.h")
+
+
+def ident(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name)
+
+
+def render():
+    lines = [
+        "#pragma once",
+        "// GENERATED by tools/embed_web.py from web/ -- do not edit",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "\tconst char*    path;",
+        "\tconst char*    type;",
+        "\tconst char*    etag;\t\t// strong, quoted",
+        "\tconst uint8_t* gz;",
+        "\tuint32_t       gzLen;",
+        "};",
+        "",
+    ]
+    table = []
+    for fname, path, ctype in ASSETS:
+        raw = open(os.path.join(WEB, fname), "rb").read()
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(raw).hexdigest()[:16]
+        var = "web_" + ident(fname)
+        lines.append(f"// {fname}: {len(raw)} -> {len(gz)} bytes")
+        lines.append(f"static const uint8_t {var}_gz[] PROGMEM = {{")
+        for i in range(0, len(gz), 16):
+            lines.append("\t" + ", ".join(f"0x{b:02x}" for b in gz[i:i + 16]) + ",")
+        lines.append("};")
+        lines.append("")
+        table.append(f'\t{{ "{path}", "{ctype}", "\\"{etag}\\"", {var}_gz, sizeof({var}_gz) }},')
+    lines.append("static const WebAsset webAssets[] = {")
+    lines.extend(table)
+    lines.append("};")
+    lines.append("")
+    return "\n".join(lines)
+
+
+def main():
+    text = render()
+    old = open(OUT).read() if os.path.exists(OUT) else None
+    if text != old:
+        with open(OUT, "w") as f:
+            f.write(text)
+        print("embed_web: wrote", os.path.relpath(OUT, ROOT))
+
+
+main()
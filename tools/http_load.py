@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Concurrent load against the portal, then print the device's handler latency.
+
+    python3 tools/http_load.py --host 192.168.4.1 --clients 16 --requests 200
+
+Each client keeps one HTTP/1.1 connection alive and alternates status reads with
+simulated nuts (known classes only, so no prompt is raised). Client-side round-trip p50/p99 are printed next to the
+device's own /api/http/latency numbers (handler time only).
+"""
+import argparse
+import http.client
+import json
+import threading
+import time
+
+CLASSES = ["Api", "Seconds", "Rashi", "Mangala"]
+
+
+def percentile(xs, p):
+    xs = sorted(xs)
+    return xs[(len(xs) - 1) * p // 100] if xs else 0
+
+
+def client(host, n, out, errors):
+    conn = http.client.HTTPConnection(host, 80, timeout=10)
+    for i in range(n):
+        if i % 2:
+            method, path = "GET", "/api/session/status"
+        else:
+            method, path = "POST", "/api/simulate?class=" + CLASSES[i // 2 % len(CLASSES)]
+        t0 = time.perf_counter()
+        try:
+            conn.request(method, path)
+            conn.getresponse().read()
+            out.append((time.perf_counter() - t0) * 1e6)
+        except (OSError, http.client.HTTPException):
+            errors.append(path)
+            conn.close()
+            conn = http.client.HTTPConnection(host, 80, timeout=10)
+    conn.close()
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--clients", type=int, default=16)
+    ap.add_argument("--requests", type=int, default=200, help="per client")
+    args = ap.parse_args()
+
+    c = http.client.HTTPConnection(args.host, 80, timeout=10)
+    c.request("GET", "/api/http/latency?reset=1")
+    c.getresponse().read()
+
+    rtt, errors = [], []
+    threads = [threading.Thread(target=client, args=(args.host, args.requests, rtt, errors))
+               for _ in range(args.clients)]
+    t0 = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    dt = time.perf_counter() - t0
+
+    c.request("GET", "/api/http/latency")
+    dev = json.loads(c.getresponse().read())
+    c.close()
+
+    print(f"{len(rtt)} ok, {len(errors)} errors, {len(rtt) / dt:.1f} req/s over {args.clients} clients")
+    print(f"round trip  p50 {percentile(rtt, 50):8.0f} us   p99 {percentile(rtt, 99):8.0f} us")
+    print(f"handler     p50 {dev['p50Us']:8d} us   p99 {dev['p99Us']:8d} us   max {dev['maxUs']} us"
+          f"  (last {dev['window']} of {dev['requests']})")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Display cost of count updates at high nut rates, read from the device's /metrics.
+
+    python3 tools/ui_bench.py --host 192.168.4.1 --rates 5,20,50 --nuts 500
+    python3 tools/ui_bench.py --host 192.168.4.1 --full 50
+
+For each rate a bulk simulation (/api/simulate/bulk) runs to completion; the deltas of
+the LVGL frame histogram and the flushed-pixel counter over the run are printed as
+frames, pixels per nut and frame time. A full-screen redraw is 240 x 320 = 76800 px,
+so "px/nut" shows directly whether updates still repaint the whole screen.
+
+--full N forces N full-screen repaints (/api/ui/redraw) and prints full-frame render
+time, time blocked on display DMA and SPI utilisation for the draw buffer size the
+firmware was built with (-D LVGL_DRAW_BUF_LINES=...); rebuild and rerun to compare.
+"""
+import argparse
+import http.client
+import json
+import re
+import time
+
+SCREEN_PX = 240 * 320
+SAMPLE = re.compile(r'^(\w+)(?:\{([^}]*)\})? (\d+)$')
+
+
+def scrape(host):
+    c = http.client.HTTPConnection(host, 80, timeout=10)
+    c.request("GET", "/metrics")
+    text = c.getresponse().read().decode()
+    c.close()
+    out = {}
+    for line in text.splitlines():
+        m = SAMPLE.match(line)
+        if m:
+            out[(m.group(1), m.group(2) or "")] = int(m.group(3))
+    return out
+
+
+def frame_buckets(m):
+    return sorted((float("inf") if le == "+Inf" else int(le), v)
+                  for (name, lbl), v in m.items()
+                  if name == "nc_lvgl_frame_microseconds_bucket"
+                  for le in [lbl.split('"')[1]])
+
+
+def bucket_percentile(before, after, p):
+    pairs = [(le, a - b) for (le, a), (_, b) in zip(frame_buckets(after), frame_buckets(before))]
+    total = pairs[-1][1] if pairs else 0
+    for le, acc in pairs:
+        if total and acc * 100 >= total * p:
+            return le
+    return 0
+
+
+def post(host, path):
+    c = http.client.HTTPConnection(host, 80, timeout=10)
+    c.request("POST", path)
+    r = c.getresponse()
+    body = r.read()
+    c.close()
+    return r.status, body
+
+
+def run(host, rate, nuts):
+    status, body = post(host, f"/api/simulate/bulk?n={nuts}&rate={rate}&dist=Api:1,Seconds:1,Rashi:1,Mangala:1")
+    if status != 200:
+        raise SystemExit(f"bulk start failed: {status} {body.decode()}")
+    before = scrape(host)
+    while True:
+        time.sleep(0.5)
+        c = http.client.HTTPConnection(host, 80, timeout=10)
+        c.request("GET", "/api/simulate/bulk")
+        rep = json.loads(c.getresponse().read())
+        c.close()
+        if rep["state"] not in ("queued", "running"):
+            break
+    time.sleep(0.2)   # let the last refresh land
+    after = scrape(host)
+
+    def d(name, lbl=""):
+        return after.get((name, lbl), 0) - before.get((name, lbl), 0)
+
+    frames = d("nc_lvgl_frame_microseconds_count")
+    frame_us = d("nc_lvgl_frame_microseconds_sum")
+    pixels = d("nc_lvgl_pixels_flushed_total")
+    done = max(rep["done"], 1)
+    print(f"{rate:5d} nut/s  {rep['done']:5d} nuts  {frames:5d} frames  "
+          f"{pixels / done:8.0f} px/nut ({pixels / done / SCREEN_PX:5.2f} screens)  "
+          f"frame mean {frame_us / max(frames, 1):7.0f} us  p99 <= {bucket_percentile(before, after, 99)} us  "
+          f"sim p99 {rep['latencyUs']['p99']} us")
+
+
+def display_line(before, after, seconds):
+    def d(name):
+        return after.get((name, ""), 0) - before.get((name, ""), 0)
+
+    frames = max(d("nc_lvgl_frame_microseconds_count"), 1)
+    hz = after.get(("nc_lvgl_spi_hz", ""), 0)
+    util = d("nc_lvgl_spi_bytes_total") * 8 / hz / seconds if hz and seconds else 0
+    return (f"{after.get(('nc_lvgl_draw_buffers', ''), 0)} x {after.get(('nc_lvgl_draw_buf_lines', ''), 0):3d} lines  "
+            f"frame mean {d('nc_lvgl_frame_microseconds_sum') / frames:7.0f} us  "
+            f"p99 <= {bucket_percentile(before, after, 99)} us  "
+            f"dma wait {d('nc_lvgl_flush_wait_microseconds_sum') / frames:6.0f} us/frame  "
+            f"spi {util * 100:5.1f}%")
+
+
+def full_frames(host, n):
+    before = scrape(host)
+    t0 = time.perf_counter()
+    for _ in range(n):
+        post(host, "/api/ui/redraw")
+        time.sleep(0.15)    # > LV_DEF_REFR_PERIOD, so every post is its own frame
+    after = scrape(host)
+    print(f"{n} full frames  " + display_line(before, after, time.perf_counter() - t0))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--rates", default="5,20,50", help="comma-separated nuts per second")
+    ap.add_argument("--nuts", type=int, default=500, help="per rate")
+    ap.add_argument("--full", type=int, default=0, help="full-screen repaints instead of nut rates")
+    args = ap.parse_args()
+    if args.full:
+        full_frames(args.host, args.full)
+        return
+    for rate in (int(r) for r in args.rates.split(",")):
+        run(args.host, rate, args.nuts)
+
+
+if __name__ == "__main__":
+    main()